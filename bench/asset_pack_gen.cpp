@@ -0,0 +1,90 @@
+/*
+ * Asset Pack Generator for Weather Display
+ *
+ * Renders every icon the firmware draws - each icon class, its night
+ * variant, at each of ASSET_ICON_SIZES - with the firmware's own
+ * renderWeatherIcon() into mock sprites, which fill circles and triangles
+ * exactly as TFT_eSPI does, and lays them out as an asset pack
+ * (include/asset_pack.h). Build it with the same colour flags as the
+ * firmware it's for:
+ *
+ *   .pio/build/native/program --write-assets assets.bin [--asset-version N]
+ */
+
+#include <vector>
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "asset_pack.h"
+
+extern TFT_eSPI tft;
+void renderWeatherIcon(TFT_eSprite &dst, int code, int x, int y, int size, bool isNight);
+
+// An OWM code of each icon class, in IconClass order
+static const int CLASS_CODES[] = {800, 801, 802, 804, 500, 200, 600, 701, 900};
+static_assert(sizeof(CLASS_CODES) / sizeof(CLASS_CODES[0]) == ICON_DEFAULT + 1, "One code per IconClass");
+
+// Transparent pixel byte, as the tiles store it
+static uint8_t assetKey()
+{
+  return ASSET_COLOR_MODE == ASSET_COLOR_PALETTE ? IconCache::KEY_COLOR & 0x0F : tft.color16to8(IconCache::KEY_COLOR);
+}
+
+// One icon as a tile of one byte per pixel - RGB332, or palette slots
+static std::vector<uint8_t> renderTile(int code, int size, bool isNight, int half)
+{
+  int dim = 2 * half;
+  bool palette = ASSET_COLOR_MODE == ASSET_COLOR_PALETTE;
+  TFT_eSprite tile(&tft);
+  tile.setColorDepth(palette ? 4 : 8);
+  const uint8_t *buf = (const uint8_t *)tile.createSprite(dim, dim);
+  std::vector<uint8_t> pixels(dim * dim);
+  if (buf == nullptr)
+    return pixels;
+  tile.fillSprite(IconCache::KEY_COLOR);
+  renderWeatherIcon(tile, code, half, half, size, isNight);
+  for (int i = 0; i < dim * dim; i++)
+    pixels[i] = !palette ? buf[i] : ((i & 1) ? buf[i >> 1] & 0x0F : buf[i >> 1] >> 4);
+  return pixels;
+}
+
+std::vector<uint8_t> buildAssetPack(uint32_t version)
+{
+  std::vector<AssetEntry> entries;
+  std::vector<uint8_t> tiles;
+  for (int cls = 0; cls <= ICON_DEFAULT; cls++)
+  {
+    for (int night = 0; night < 2; night++)
+    {
+      if (night && !iconNight((IconClass)cls, true))
+        continue;
+      for (uint8_t size : ASSET_ICON_SIZES)
+      {
+        int half = iconTileHalf(size);
+        std::vector<uint8_t> pixels = renderTile(CLASS_CODES[cls], size, night, half);
+        uint32_t at = tiles.size();
+        tiles.resize(at + AssetPack::encodeTile(pixels.data(), 2 * half, assetKey(), nullptr));
+        AssetPack::encodeTile(pixels.data(), 2 * half, assetKey(), tiles.data() + at);
+        entries.push_back({(uint8_t)cls, size, (uint8_t)night, (uint8_t)half, at});
+      }
+    }
+  }
+
+  uint32_t tilesAt = sizeof(AssetPackHeader) + entries.size() * sizeof(AssetEntry);
+  for (AssetEntry &e : entries)
+    e.offset += tilesAt;
+
+  std::vector<uint8_t> pack(tilesAt + tiles.size());
+  memcpy(pack.data() + sizeof(AssetPackHeader), entries.data(), entries.size() * sizeof(AssetEntry));
+  memcpy(pack.data() + tilesAt, tiles.data(), tiles.size());
+
+  AssetPackHeader h = {};
+  h.magic = ASSET_PACK_MAGIC;
+  h.format = ASSET_PACK_FORMAT;
+  h.colorMode = ASSET_COLOR_MODE;
+  h.count = entries.size();
+  h.version = version;
+  h.size = pack.size();
+  h.crc = crc32_le(0, pack.data() + sizeof(AssetPackHeader), pack.size() - sizeof(AssetPackHeader));
+  memcpy(pack.data(), &h, sizeof(h));
+  return pack;
+}
@@ -0,0 +1,764 @@
+/*
+ * Host Benchmark for Weather Display
+ *
+ * Runs the firmware's One Call parse and screen renderers on the host
+ * against recorded payloads in bench/payloads, with the network,
+ * display and RTOS mocked out (bench/mock). Prints time, heap allocations
+ * and draw work per operation, what a one-number refresh pushes, and the
+ * cost of converting and pushing a full frame in the build's frame mode.
+ * Round-trips the reading history through its codec and NVS, and fails if
+ * any figure is above its limit in bench/thresholds.txt.
+ *
+ *   pio run -e native -t exec                         run and check
+ *   .pio/build/native/program --record                rewrite the thresholds
+ *   .pio/build/native/program --iterations 500 dir/   other payloads
+ *   .pio/build/native/program --write-assets FILE     icon asset pack
+ */
+
+#include <chrono>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include <TFT_eSPI.h>
+#include "types.h"
+#include "helpers.h"
+#include "counting_allocator.h"
+#include "dma_push.h"
+#include "text_metrics.h"
+#include "locations.h"
+#include "icon_cache.h"
+#include "asset_pack.h"
+#include "history_ring.h"
+
+// Firmware state and entry points (src/main.cpp)
+extern TFT_eSPI tft;
+extern TFT_eSprite sprite;
+extern CountingAllocator jsonAllocator;
+extern TextMetrics text;
+extern DmaBandPusher dmaPusher;
+extern LocationWeather locationWeather[];
+extern const char *POSIX_TZ;
+extern IconCache iconCache;
+bool initFrameBuffer();
+bool fetchOneCallData(const Location &where, WeatherData &out, uint8_t sections);
+void displayScreen(Screen screen);
+void showWeather(const WeatherData *data);
+void renderWeatherIcon(TFT_eSprite &dst, int code, int x, int y, int size, bool isNight);
+std::vector<uint8_t> buildAssetPack(uint32_t version); // asset_pack_gen.cpp
+
+// The mock server ignores the query, so any coordinates do
+static const Location benchLocation = {"Bench", "0", "0"};
+
+// Every operator new is counted - String temporaries show up here
+static size_t heapAllocations = 0;
+
+void *operator new(size_t size)
+{
+  heapAllocations++;
+  if (void *p = malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+struct Result
+{
+  std::string name;
+  std::map<std::string, double> metrics; // Per operation
+};
+
+static const char *THRESHOLDS_FILE = "bench/thresholds.txt";
+static const char *PAYLOAD_DIR = "bench/payloads";
+
+static std::string readFile(const std::string &path)
+{
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+static std::vector<std::string> listPayloads(const std::string &dir)
+{
+  std::vector<std::string> files;
+  if (DIR *d = opendir(dir.c_str()))
+  {
+    while (dirent *e = readdir(d))
+    {
+      std::string name = e->d_name;
+      if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0)
+        files.push_back(name);
+    }
+    closedir(d);
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+// The payload's own timestamp, so "now" matches the data
+static time_t payloadTime(const std::string &json)
+{
+  size_t at = json.find("\"current\"");
+  at = json.find("\"dt\":", at == std::string::npos ? 0 : at);
+  return at == std::string::npos ? 0 : (time_t)atol(json.c_str() + at + 5);
+}
+
+static double elapsedNs(std::chrono::steady_clock::time_point start)
+{
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// body is what goes over the wire - the JSON itself, or its relay snapshot
+static Result benchParse(const std::string &file, const std::string &json, const std::string &body, int iterations)
+{
+  Result r{"parse:" + file.substr(0, file.size() - 5), {}};
+  mock::serve(body);
+  mock::clock = payloadTime(json);
+
+  WeatherData &out = locationWeather[0].buffers[0];
+  if (!fetchOneCallData(benchLocation, out, SECTIONS_ALL))
+  {
+    fprintf(stderr, "%s: parse failed\n", file.c_str());
+    exit(2);
+  }
+
+  size_t allocsBefore = heapAllocations;
+  uint32_t jsonAllocs = 0;
+  size_t jsonPeak = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+  {
+    fetchOneCallData(benchLocation, out, SECTIONS_ALL);
+    jsonAllocs += jsonAllocator.allocations;
+    jsonPeak = max(jsonPeak, jsonAllocator.peak);
+  }
+  size_t allocs = heapAllocations - allocsBefore; // Before the metrics map allocates
+  r.metrics["ns"] = elapsedNs(start) / iterations;
+  r.metrics["allocs"] = (double)(allocs + jsonAllocs) / iterations;
+  r.metrics["jsonPeak"] = (double)jsonPeak;
+  r.metrics["bytes"] = (double)body.size();
+  return r;
+}
+
+static Result benchScreen(const std::string &name, Screen screen, int iterations)
+{
+  Result r{"render:" + name, {}};
+  displayScreen(screen); // Warm the icon cache and static state
+
+  sprite.stats = DrawStats();
+  tft.stats = DrawStats();
+  size_t allocsBefore = heapAllocations;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    displayScreen(screen);
+  size_t allocs = heapAllocations - allocsBefore; // Before the metrics map allocates
+  r.metrics["ns"] = elapsedNs(start) / iterations;
+  r.metrics["allocs"] = (double)allocs / iterations;
+  r.metrics["primitives"] = (double)sprite.stats.primitives / iterations;
+  r.metrics["pixels"] = (double)sprite.stats.pixels / iterations;
+  r.metrics["glyphs"] = (double)sprite.stats.glyphs / iterations;
+  r.metrics["pushed"] = (double)tft.stats.pushed / iterations;
+  return r;
+}
+
+// A refresh where one number on the screen changes - what the frame diff
+// leaves to push for a typical 5-minute update. Cloud cover steps between
+// 9% and 10% so the change shows up in the mock's fixed-cell text.
+static Result benchRefresh(const std::string &name, int iterations)
+{
+  Result r{"refresh:" + name, {}};
+  WeatherData &data = locationWeather[0].buffers[0];
+  int clouds = data.clouds;
+  displayScreen(SCREEN_CONDITIONS);
+
+  tft.stats = DrawStats();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+  {
+    data.clouds = 9 + (i & 1);
+    displayScreen(SCREEN_CONDITIONS);
+  }
+  r.metrics["ns"] = elapsedNs(start) / iterations;
+  r.metrics["pushed"] = (double)tft.stats.pushed / iterations;
+  data.clouds = clouds;
+  return r;
+}
+
+// The float and branch mappings the lookup tables replaced, for comparison
+static uint16_t referenceTempColor(float temp)
+{
+  if (temp <= 15)
+    return COLOR_RAIN;
+  if (temp >= 40)
+    return COLOR_ACCENT;
+  if (temp >= 24 && temp <= 26)
+    return COLOR_TEXT;
+  if (temp < 24)
+  {
+    float ratio = (temp - 15.0) / 9.0;
+#ifdef PALETTE_FRAME
+    return ratio < 0.25 ? COLOR_RAIN : (ratio < 0.75 ? COLOR_TEMP_COOL : COLOR_TEXT);
+#else
+    return frameColor(ratio * 255, ratio * 255, 255);
+#endif
+  }
+  float ratio = (temp - 26.0) / 14.0;
+#ifdef PALETTE_FRAME
+  return ratio < 0.25 ? COLOR_TEXT : (ratio < 0.75 ? COLOR_TEMP_WARM : COLOR_ACCENT);
+#else
+  return frameColor(255, 255 - (ratio * 155), 255 - (ratio * 255));
+#endif
+}
+
+static String referenceUVDescription(float uvi)
+{
+  if (uvi < 3)
+    return "Low";
+  if (uvi < 6)
+    return "Moderate";
+  if (uvi < 8)
+    return "High";
+  if (uvi < 11)
+    return "Very High";
+  return "Extreme";
+}
+
+static uint16_t referenceUVColor(float uvi)
+{
+  if (uvi < 3)
+    return COLOR_SUCCESS;
+  if (uvi < 6)
+    return COLOR_SUN;
+  if (uvi < 8)
+    return COLOR_ACCENT;
+  if (uvi < 11)
+    return COLOR_ALERT;
+  return COLOR_EXTREME;
+}
+
+// Per-lookup cost of a colour mapping over a sweep of inputs. mismatches
+// counts sweep points where the lookup differs from the reference - for
+// temperatures only the table's own grid points are compared, since the
+// table rounds to the nearest step.
+template <typename Map>
+static Result benchMapping(const std::string &name, float from, float to, float step, int iterations, Map map)
+{
+  Result r{"map:" + name, {}};
+  std::vector<float> inputs;
+  for (float v = from; v <= to; v += step)
+    inputs.push_back(v);
+
+  size_t allocsBefore = heapAllocations;
+  volatile uint32_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    for (float v : inputs)
+      sink = sink + map(v);
+  size_t allocs = heapAllocations - allocsBefore; // Before the metrics map allocates
+  r.metrics["ns"] = elapsedNs(start) / ((double)iterations * inputs.size());
+  r.metrics["allocs"] = (double)allocs / ((double)iterations * inputs.size());
+  return r;
+}
+
+static std::vector<Result> benchColorMaps(int iterations)
+{
+  std::vector<Result> results;
+  results.push_back(benchMapping("temp_color", -15, 55, 0.1f, iterations, getTempColor));
+  results.push_back(benchMapping("temp_color_float", -15, 55, 0.1f, iterations, referenceTempColor));
+  results.push_back(benchMapping("uv", -1, 14, 0.05f, iterations, [](float uvi)
+                                 { return getUVColor(uvi) + (uint32_t)strlen(getUVDescription(uvi)); }));
+  results.push_back(benchMapping("uv_branches", -1, 14, 0.05f, iterations, [](float uvi)
+                                 { return referenceUVColor(uvi) + (uint32_t)referenceUVDescription(uvi).length(); }));
+
+  int tempMismatches = 0;
+  for (int i = 0; i < TEMP_LUT_SIZE; i++)
+  {
+    float t = TEMP_LUT_MIN + (float)i / TEMP_LUT_STEPS;
+    tempMismatches += getTempColor(t) != referenceTempColor(t);
+  }
+  results[0].metrics["mismatches"] = tempMismatches;
+
+  int uvMismatches = 0;
+  for (int i = -100; i <= 1400; i++)
+  {
+    float uvi = i / 100.0f;
+    uvMismatches += getUVColor(uvi) != referenceUVColor(uvi) || referenceUVDescription(uvi) != getUVDescription(uvi);
+  }
+  results[2].metrics["mismatches"] = uvMismatches;
+  return results;
+}
+
+// One icon of every kind the asset pack holds: rendered from primitives,
+// blitted from the icon cache, blitted from the pack. The pack's
+// mismatches count icons whose pixels differ from the cache's.
+static std::vector<Result> benchIcons(int iterations)
+{
+  struct Icon
+  {
+    int code;
+    int size;
+    bool night;
+  };
+  std::vector<Icon> icons;
+  static const int codes[] = {800, 801, 802, 804, 500, 200, 600, 701, 900};
+  for (int code : codes)
+    for (uint8_t size : ASSET_ICON_SIZES)
+      for (int night = 0; night < 2; night++)
+        icons.push_back({code, size, night != 0});
+
+  std::vector<uint8_t> bytes = buildAssetPack(1);
+  AssetPack pack(&tft);
+  if (!pack.open(bytes.data(), bytes.size()))
+  {
+    fprintf(stderr, "Generated asset pack failed its check: %s\n", AssetPack::check(bytes.data(), bytes.size()));
+    exit(2);
+  }
+
+  // A frame of the build's depth, one icon tile across
+  TFT_eSprite frame(&tft);
+  frame.setColorDepth(sprite.getColorDepth());
+  frame.createSprite(80, 80);
+  size_t frameBytes = (size_t)80 * 80 * frame.getColorDepth() / 8;
+
+  auto measure = [&](const std::string &name, const std::function<bool(const Icon &)> &draw)
+  {
+    Result r{"icon:" + name, {}};
+    // Each icon in turn, so the icon cache (smaller than the whole set)
+    // is timed on hits. One untimed pass first, so one-off setup isn't
+    // counted against every draw.
+    for (const Icon &icon : icons)
+      draw(icon);
+    size_t allocsBefore = heapAllocations;
+    auto start = std::chrono::steady_clock::now();
+    for (const Icon &icon : icons)
+      for (int i = 0; i < iterations; i++)
+        draw(icon);
+    size_t allocs = heapAllocations - allocsBefore; // Before the metrics map allocates
+    r.metrics["ns"] = elapsedNs(start) / ((double)iterations * icons.size());
+    r.metrics["allocs"] = (double)allocs / ((double)iterations * icons.size());
+    return r;
+  };
+
+  std::vector<Result> results;
+  results.push_back(measure("render", [&](const Icon &i)
+                         {
+                           renderWeatherIcon(frame, i.code, 40, 40, i.size, i.night);
+                           return true; }));
+  results.push_back(measure("cache", [&](const Icon &i)
+                         {
+                           iconCache.draw(frame, i.code, 40, 40, i.size, i.night);
+                           return true; }));
+  results.push_back(measure("pack", [&](const Icon &i)
+                         { return pack.draw(frame, i.code, 40, 40, i.size, i.night); }));
+
+  int mismatches = 0;
+  std::vector<uint8_t> cached(frameBytes);
+  for (const Icon &icon : icons)
+  {
+    frame.fillSprite(COLOR_BG);
+    iconCache.draw(frame, icon.code, 40, 40, icon.size, icon.night);
+    memcpy(cached.data(), frame.getPointer(), frameBytes);
+    frame.fillSprite(COLOR_BG);
+    bool drawn = pack.draw(frame, icon.code, 40, 40, icon.size, icon.night);
+    mismatches += !drawn || memcmp(cached.data(), frame.getPointer(), frameBytes) != 0;
+  }
+  results.back().metrics["mismatches"] = mismatches;
+  results.back().metrics["bytes"] = (double)bytes.size();
+  return results;
+}
+
+// Readings for the history round trip: mostly consecutive slots with small
+// changes, plus gaps and jumps that need multi-byte varints and negative
+// deltas. Deterministic, so every run checks the same history.
+static std::vector<WeatherData> historyReadings(int count, std::vector<HistorySample> &expected)
+{
+  std::vector<WeatherData> readings;
+  uint32_t seed = 12345;
+  auto rnd = [&seed](uint32_t n)
+  {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % n;
+  };
+  HistorySample s = {1700000000 / HistoryRing::SLOT_SECONDS, {215, 1013, 60, 35}};
+  for (int i = 0; i < count; i++)
+  {
+    uint32_t kind = rnd(100);
+    s.slot += kind < 90 ? 1 : kind < 99 ? 2 + rnd(40) : 20000 + rnd(100000);
+    for (int c = 0; c < HIST_CHANNELS; c++)
+      s.value[c] += kind < 97 ? (int)rnd(7) - 3 : (int)rnd(2001) - 1000;
+    s.value[HIST_HUMIDITY] = max((int16_t)0, min(s.value[HIST_HUMIDITY], (int16_t)100));
+    s.value[HIST_WIND] = max((int16_t)0, s.value[HIST_WIND]);
+
+    WeatherData d = {};
+    d.temperature = s.value[HIST_TEMPERATURE] / 10.0f;
+    d.pressure = s.value[HIST_PRESSURE];
+    d.humidity = s.value[HIST_HUMIDITY];
+    d.windSpeed = s.value[HIST_WIND] / 10.0f;
+    d.sectionUpdated[SECTION_CURRENT] = (time_t)s.slot * HistoryRing::SLOT_SECONDS;
+    readings.push_back(d);
+    expected.push_back(s);
+  }
+  return readings;
+}
+
+static std::vector<HistorySample> readHistory(const HistoryRing &ring)
+{
+  std::vector<HistorySample> out;
+  HistoryRing::Cursor c;
+  ring.seek(c, 0);
+  HistorySample s;
+  while (ring.next(c, s))
+    out.push_back(s);
+  return out;
+}
+
+static bool sameSample(const HistorySample &a, const HistorySample &b)
+{
+  return a.slot == b.slot && memcmp(a.value, b.value, sizeof(a.value)) == 0;
+}
+
+// Whether got is a non-empty run of want ending at its newest sample - what
+// the ring keeps once older blocks are overwritten or dropped
+static bool isTailOf(const std::vector<HistorySample> &got, const std::vector<HistorySample> &want)
+{
+  if (got.empty() || got.size() > want.size())
+    return false;
+  size_t from = want.size() - got.size();
+  for (size_t i = 0; i < got.size(); i++)
+  {
+    if (!sameSample(got[i], want[from + i]))
+      return false;
+  }
+  return true;
+}
+
+static bool loadHistoryBlock(int index, HistoryBlock &b)
+{
+  Preferences prefs;
+  prefs.begin("history", true);
+  char key[8];
+  snprintf(key, sizeof(key), "b%02d", index);
+  bool ok = prefs.getBytes(key, &b, sizeof(b)) == sizeof(b);
+  prefs.end();
+  return ok;
+}
+
+static void storeHistoryBlock(int index, const HistoryBlock &b)
+{
+  Preferences prefs;
+  prefs.begin("history", false);
+  char key[8];
+  snprintf(key, sizeof(key), "b%02d", index);
+  prefs.putBytes(key, &b, sizeof(b));
+  prefs.end();
+}
+
+static void clearHistoryNvs()
+{
+  Preferences prefs;
+  prefs.begin("history", false);
+  for (int i = 0; i < HistoryRing::BLOCKS; i++)
+  {
+    char key[8];
+    snprintf(key, sizeof(key), "b%02d", i);
+    prefs.remove(key);
+  }
+  prefs.end();
+}
+
+// Append cost of the delta-coded history, and its round trips: what is read
+// back, from RAM and from NVS, must be the newest readings appended. A block
+// that fails its CRC, and blocks left from an older sequence, must cut the
+// history there rather than splice in other samples. mismatches counts
+// failed checks.
+static Result benchHistory(int iterations)
+{
+  Result r{"history", {}};
+  const int readingCount = 3000; // Wraps the ring about three times
+  std::vector<HistorySample> expected;
+  std::vector<WeatherData> readings = historyReadings(readingCount, expected);
+  static HistoryRing ring, loaded, fresh; // 6 KB each
+  int mismatches = 0;
+
+  size_t allocsBefore = heapAllocations;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+  {
+    ring = HistoryRing();
+    for (const WeatherData &d : readings)
+      mismatches += !ring.append(d.sectionUpdated[SECTION_CURRENT], d);
+  }
+  size_t allocs = heapAllocations - allocsBefore; // Before the metrics map allocates
+  r.metrics["ns"] = elapsedNs(start) / ((double)iterations * readingCount);
+  r.metrics["allocs"] = (double)allocs / ((double)iterations * readingCount);
+
+  std::vector<HistorySample> inRam = readHistory(ring);
+  mismatches += !isTailOf(inRam, expected) || inRam.size() < (size_t)readingCount / 4;
+  r.metrics["bytes"] = (double)sizeof(HistoryBlock) * HistoryRing::BLOCKS / inRam.size();
+
+  // Through NVS and back
+  clearHistoryNvs();
+  time_t later = (time_t)expected.back().slot * HistoryRing::SLOT_SECONDS;
+  ring.persist(later);
+  loaded.load();
+  std::vector<HistorySample> restored = readHistory(loaded);
+  mismatches += restored.size() != inRam.size() || !isTailOf(restored, inRam);
+
+  // A block that fails its CRC: the history restarts after it
+  uint32_t newestSeq = 0;
+  for (int i = 0; i < HistoryRing::BLOCKS; i++)
+  {
+    HistoryBlock b;
+    if (loadHistoryBlock(i, b))
+      newestSeq = max(newestSeq, b.seq);
+  }
+  HistoryBlock broken;
+  int brokenAt = (newestSeq - 3) % HistoryRing::BLOCKS;
+  loadHistoryBlock(brokenAt, broken);
+  broken.data[0] ^= 0xFF;
+  storeHistoryBlock(brokenAt, broken);
+  loaded = HistoryRing();
+  loaded.load();
+  std::vector<HistorySample> cut = readHistory(loaded);
+  mismatches += cut.size() >= restored.size() || !isTailOf(cut, inRam);
+
+  // Blocks of a history begun afresh (seq from 0) among the newer ones:
+  // they are dropped, not read as part of it
+  clearHistoryNvs();
+  ring = HistoryRing();
+  for (const WeatherData &d : readings)
+    ring.append(d.sectionUpdated[SECTION_CURRENT], d);
+  ring.persist(later);
+  std::vector<HistorySample> ignored;
+  std::vector<WeatherData> few = historyReadings(40, ignored);
+  for (WeatherData &d : few)
+    d.sectionUpdated[SECTION_CURRENT] -= 86400 * 365; // Older than anything in ring
+  for (const WeatherData &d : few)
+    fresh.append(d.sectionUpdated[SECTION_CURRENT], d);
+  fresh.persist(later); // Into block 0, which ring's head isn't in
+  loaded = HistoryRing();
+  loaded.load();
+  std::vector<HistorySample> mixed = readHistory(loaded);
+  mismatches += newestSeq % HistoryRing::BLOCKS == 0 || !isTailOf(mixed, inRam);
+
+  clearHistoryNvs();
+  r.metrics["mismatches"] = mismatches;
+  return r;
+}
+
+static int writeAssets(const std::string &path, uint32_t version)
+{
+  std::vector<uint8_t> pack = buildAssetPack(version);
+  std::ofstream out(path, std::ios::binary);
+  out.write((const char *)pack.data(), pack.size());
+  if (!out)
+  {
+    fprintf(stderr, "Can't write %s\n", path.c_str());
+    return 2;
+  }
+  printf("%s: asset pack v%u, %u bytes\n", path.c_str(), (unsigned)version, (unsigned)pack.size());
+  return 0;
+}
+
+// Full-frame DMA push - named per bpp so 8-bit and palettized builds keep
+// separate limits
+static Result benchPush(int iterations)
+{
+  int depth = sprite.getColorDepth();
+  int w = sprite.width(), h = sprite.height();
+  Result r{"push:" + std::to_string(depth) + "bpp", {}};
+  tft.stats = DrawStats();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    dmaPusher.push(tft, sprite, 0, 0, w, h);
+  r.metrics["ns"] = elapsedNs(start) / iterations;
+  r.metrics["pushed"] = (double)tft.stats.pushed / iterations;
+  r.metrics["bytes"] = (double)w * h * depth / 8;
+  return r;
+}
+
+// "name metric max" per line, # comments
+static std::map<std::string, double> loadThresholds()
+{
+  std::map<std::string, double> limits;
+  std::ifstream in(THRESHOLDS_FILE);
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    std::string name, metric;
+    double limit;
+    if (fields >> name >> metric >> limit)
+      limits[name + " " + metric] = limit;
+  }
+  return limits;
+}
+
+// Mismatches fail on any count, recorded or not: the fast path has to draw
+// exactly what it replaced
+static bool checkedAtZero(const std::string &metric)
+{
+  return metric == "mismatches";
+}
+
+// Timings get headroom for machine noise; counts are deterministic, so any rise fails
+static void recordThresholds(const std::vector<Result> &results)
+{
+  std::ofstream out(THRESHOLDS_FILE);
+  out << "# Benchmark limits - any figure above its limit fails the run.\n"
+         "# Written by --record: ns has 30% headroom, counts are exact.\n"
+         "# Re-record on the reference machine after intended changes.\n";
+  for (const Result &r : results)
+    for (const auto &m : r.metrics)
+    {
+      if (m.first == "bytes" || checkedAtZero(m.first))
+        continue;
+      double limit = m.first == "ns" ? m.second * 1.3 : m.second;
+      out << r.name << " " << m.first << " " << (uint64_t)ceil(limit) << "\n";
+    }
+  printf("Thresholds written to %s\n", THRESHOLDS_FILE);
+}
+
+int main(int argc, char **argv)
+{
+  int iterations = 200;
+  bool record = false;
+  std::string payloadDir = PAYLOAD_DIR;
+  std::string assetsPath;
+  uint32_t assetVersion = (uint32_t)time(nullptr);
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "--record")
+      record = true;
+    else if (arg == "--verbose")
+      mock::serialEcho = true;
+    else if (arg == "--iterations" && i + 1 < argc)
+      iterations = max(1, atoi(argv[++i]));
+    else if (arg == "--write-assets" && i + 1 < argc)
+      assetsPath = argv[++i];
+    else if (arg == "--asset-version" && i + 1 < argc)
+      assetVersion = strtoul(argv[++i], nullptr, 10);
+    else
+      payloadDir = arg;
+  }
+
+  setenv("TZ", POSIX_TZ, 1);
+  tzset();
+
+  // Same frame setup as setup()
+  tft.setRotation(1);
+  if (!initFrameBuffer())
+  {
+    fprintf(stderr, "Frame buffer allocation failed\n");
+    return 2;
+  }
+  text.begin();
+
+  if (!assetsPath.empty())
+    return writeAssets(assetsPath, assetVersion);
+
+  std::vector<std::string> files = listPayloads(payloadDir);
+  if (files.empty())
+  {
+    fprintf(stderr, "No payloads in %s\n", payloadDir.c_str());
+    return 2;
+  }
+
+  std::vector<Result> results;
+  for (const std::string &file : files)
+  {
+    std::string json = readFile(payloadDir + "/" + file);
+#ifdef WEATHER_RELAY_HOST
+    // Built with tools/relay/owm_relay.py convert
+    std::string body = readFile(payloadDir + "/" + file.substr(0, file.size() - 5) + ".msgpack");
+    if (body.empty())
+    {
+      fprintf(stderr, "%s: no .msgpack snapshot alongside\n", file.c_str());
+      return 2;
+    }
+#else
+    const std::string &body = json;
+#endif
+    results.push_back(benchParse(file, json, body, iterations));
+
+    // Render the screens with this payload's data
+    showWeather(&locationWeather[0].buffers[0]);
+    static const struct
+    {
+      const char *name;
+      Screen screen;
+    } screens[] = {
+        {"hourly", SCREEN_HOURLY},
+        {"hourly2", SCREEN_HOURLY2},
+        {"conditions", SCREEN_CONDITIONS},
+        {"daily", SCREEN_DAILY},
+    };
+    for (const auto &s : screens)
+      results.push_back(benchScreen(std::string(s.name) + ":" + file.substr(0, file.size() - 5), s.screen, iterations));
+    results.push_back(benchRefresh(file.substr(0, file.size() - 5), iterations));
+  }
+
+  // Settings-mode screens don't depend on the forecast
+  results.push_back(benchScreen("settings", SCREEN_SETTINGS, iterations));
+  results.push_back(benchScreen("about", SCREEN_ABOUT, iterations));
+  results.push_back(benchScreen("demo", SCREEN_DEMO, iterations));
+  results.push_back(benchScreen("demo2", SCREEN_DEMO2, iterations));
+  results.push_back(benchScreen("demo3", SCREEN_DEMO3, iterations));
+
+  for (const Result &r : benchColorMaps(iterations))
+    results.push_back(r);
+  for (const Result &r : benchIcons(iterations))
+    results.push_back(r);
+  results.push_back(benchHistory(iterations));
+
+  // Banded builds have no full frame to push
+  if (dmaPusher.ready())
+    results.push_back(benchPush(iterations));
+
+  if (record)
+  {
+    recordThresholds(results);
+    return 0;
+  }
+
+  std::map<std::string, double> limits = loadThresholds();
+  int failures = 0;
+  printf("%-30s %-11s %14s %14s\n", "benchmark", "metric", "per op", "limit");
+  for (const Result &r : results)
+  {
+    for (const auto &m : r.metrics)
+    {
+      auto limit = limits.find(r.name + " " + m.first);
+      if (checkedAtZero(m.first))
+      {
+        bool wrong = m.second != 0;
+        failures += wrong;
+        printf("%-30s %-11s %14.1f %14d%s\n", r.name.c_str(), m.first.c_str(), m.second, 0, wrong ? "  MISMATCH" : "");
+        continue;
+      }
+      bool over = limit != limits.end() && m.second > limit->second;
+      failures += over;
+      if (limit != limits.end())
+        printf("%-30s %-11s %14.1f %14.0f%s\n", r.name.c_str(), m.first.c_str(), m.second, limit->second,
+               over ? "  REGRESSION" : "");
+      else
+        printf("%-30s %-11s %14.1f %14s\n", r.name.c_str(), m.first.c_str(), m.second, "-");
+    }
+  }
+
+  if (limits.empty())
+    printf("\nNo thresholds recorded - run with --record to create %s\n", THRESHOLDS_FILE);
+  printf("\n%d regression%s\n", failures, failures == 1 ? "" : "s");
+  return failures > 0 ? 1 : 0;
+}
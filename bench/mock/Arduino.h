@@ -0,0 +1,370 @@
+/*
+ * Host Arduino Core Shim for Weather Display Benchmarks
+ *
+ * Just enough of the ESP32 Arduino core (String, Print/Stream, Serial,
+ * timing, GPIO, FreeRTOS, ESP) for src/main.cpp to build and run under the
+ * native PlatformIO env. FreeRTOS calls are no-ops - the benchmark calls
+ * the parse and draw functions directly instead of running setup()/loop().
+ */
+
+#ifndef MOCK_ARDUINO_H
+#define MOCK_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+#include <time.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+using std::max;
+using std::min;
+
+// Shared mock state, set by the benchmark
+namespace mock
+{
+  extern time_t clock;     // What time() and getLocalTime() report
+  extern bool serialEcho;  // Print Serial output to stdout
+}
+
+// The firmware reads the wall clock through time(); route it to the mock clock
+time_t mockTime(time_t *out);
+#define time(t) mockTime(t)
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 1
+#define OUTPUT 3
+#define INPUT_PULLUP 5
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+#define F(x) x
+#define digitalPinToInterrupt(p) (p)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+size_t strlcpy(char *dst, const char *src, size_t size);
+size_t strlcat(char *dst, const char *src, size_t size);
+#endif
+
+class String
+{
+public:
+  String() {}
+  String(const char *c) : s(c ? c : "") {}
+  String(const std::string &c) : s(c) {}
+  String(char c) : s(1, c) {}
+  String(int v, unsigned char base = 10) : s(format(v, base)) {}
+  String(unsigned v, unsigned char base = 10) : s(format(v, base)) {}
+  String(long v, unsigned char base = 10) : s(format(v, base)) {}
+  String(unsigned long v, unsigned char base = 10) : s(format(v, base)) {}
+  String(float v, unsigned char decimals = 2) : s(format((double)v, decimals)) {}
+  String(double v, unsigned char decimals = 2) : s(format(v, decimals)) {}
+
+  unsigned length() const { return s.size(); }
+  const char *c_str() const { return s.c_str(); }
+  char &operator[](unsigned i) { return s[i]; }
+  char operator[](unsigned i) const { return s[i]; }
+  char charAt(unsigned i) const { return i < s.size() ? s[i] : 0; }
+  bool reserve(unsigned n)
+  {
+    s.reserve(n);
+    return true;
+  }
+
+  String &operator+=(const String &o)
+  {
+    s += o.s;
+    return *this;
+  }
+  String &operator+=(const char *o)
+  {
+    s += o;
+    return *this;
+  }
+  String &operator+=(char o)
+  {
+    s += o;
+    return *this;
+  }
+  bool concat(const char *o)
+  {
+    s += o;
+    return true;
+  }
+  bool concat(char o)
+  {
+    s += o;
+    return true;
+  }
+  friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+  friend String operator+(const String &a, const char *b) { return String(a.s + b); }
+  friend String operator+(const char *a, const String &b) { return String(std::string(a) + b.s); }
+  friend String operator+(const String &a, char b) { return String(a.s + b); }
+  bool operator==(const String &o) const { return s == o.s; }
+  bool operator==(const char *o) const { return s == o; }
+  bool operator!=(const String &o) const { return s != o.s; }
+
+  String substring(unsigned from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+  String substring(unsigned from, unsigned to) const
+  {
+    if (from > to)
+      std::swap(from, to);
+    return from < s.size() ? String(s.substr(from, to - from)) : String();
+  }
+  int indexOf(char c, unsigned from = 0) const
+  {
+    size_t p = s.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(const char *str, unsigned from = 0) const
+  {
+    size_t p = s.find(str, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int lastIndexOf(char c) const
+  {
+    size_t p = s.rfind(c);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  bool startsWith(const char *prefix) const { return s.compare(0, strlen(prefix), prefix) == 0; }
+  void trim()
+  {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    size_t b = s.find_last_not_of(" \t\r\n");
+    s = (a == std::string::npos) ? std::string() : s.substr(a, b - a + 1);
+  }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return (float)atof(s.c_str()); }
+
+private:
+  std::string s;
+
+  static std::string format(long long v, unsigned char base)
+  {
+    if (base == 10)
+      return std::to_string(v);
+    char buf[70];
+    int i = sizeof(buf) - 1;
+    buf[i] = '\0';
+    unsigned long long u = v < 0 ? -(unsigned long long)v : (unsigned long long)v;
+    do
+    {
+      buf[--i] = "0123456789abcdef"[u % base];
+      u /= base;
+    } while (u > 0);
+    if (v < 0)
+      buf[--i] = '-';
+    return buf + i;
+  }
+  static std::string format(int v, unsigned char base) { return format((long long)v, base); }
+  static std::string format(long v, unsigned char base) { return format((long long)v, base); }
+  static std::string format(unsigned v, unsigned char base) { return format((long long)v, base); }
+  static std::string format(unsigned long v, unsigned char base) { return format((long long)v, base); }
+  static std::string format(double v, unsigned char decimals)
+  {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    return buf;
+  }
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n)
+  {
+    size_t done = 0;
+    while (n--)
+      done += write(*buf++);
+    return done;
+  }
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+
+  size_t print(const char *v) { return write(v); }
+  size_t print(const String &v) { return write(v.c_str()); }
+  size_t print(char v) { return write((uint8_t)v); }
+  size_t print(int v, int base = 10) { return print(String(v, base)); }
+  size_t print(unsigned v, int base = 10) { return print(String(v, base)); }
+  size_t print(long v, int base = 10) { return print(String(v, base)); }
+  size_t print(unsigned long v, int base = 10) { return print(String(v, base)); }
+  size_t print(double v, int digits = 2) { return print(String(v, digits)); }
+  template <typename T>
+  auto print(const T &v) -> decltype(v.toString(), size_t()) { return print(v.toString()); }
+
+  template <typename T>
+  size_t println(const T &v)
+  {
+    size_t n = print(v);
+    return n + println();
+  }
+  template <typename T>
+  size_t println(const T &v, int format)
+  {
+    size_t n = print(v, format);
+    return n + println();
+  }
+  size_t println() { return write("\r\n"); }
+
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)))
+  {
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (len < 0)
+      return 0;
+    return write((const uint8_t *)buf, min((size_t)len, sizeof(buf) - 1));
+  }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long ms) { timeout = ms; }
+  size_t readBytes(char *buf, size_t n)
+  {
+    size_t got = 0;
+    while (got < n)
+    {
+      int c = read();
+      if (c < 0)
+        break;
+      buf[got++] = (char)c;
+    }
+    return got;
+  }
+  size_t readBytes(uint8_t *buf, size_t n) { return readBytes((char *)buf, n); }
+
+protected:
+  unsigned long timeout = 1000;
+};
+
+class HardwareSerial : public Stream
+{
+public:
+  void begin(unsigned long) {}
+  void flush() { fflush(stdout); }
+  operator bool() const { return true; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t c) override
+  {
+    if (mock::serialEcho)
+      fputc(c, stdout);
+    return 1;
+  }
+  size_t write(const uint8_t *buf, size_t n) override
+  {
+    if (mock::serialEcho)
+      fwrite(buf, 1, n, stdout);
+    return n;
+  }
+  using Print::write;
+};
+extern HardwareSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned us);
+void yield();
+void pinMode(int pin, int mode);
+int digitalRead(int pin);
+void digitalWrite(int pin, int value);
+void attachInterrupt(int pin, void (*isr)(), int mode);
+void attachInterruptArg(int pin, void (*isr)(void *), void *arg, int mode);
+void detachInterrupt(int pin);
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+class IPAddress
+{
+public:
+  IPAddress() {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : addr(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+  IPAddress(uint32_t raw) : addr(raw) {}
+  operator uint32_t() const { return addr; }
+  String toString() const
+  {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", addr & 0xFF, (addr >> 8) & 0xFF, (addr >> 16) & 0xFF, addr >> 24);
+    return String(buf);
+  }
+  bool fromString(const char *) { return false; }
+
+private:
+  uint32_t addr = 0;
+};
+
+class EspClass
+{
+public:
+  // Fixed figures that look like a running ESP32 - heap is not modelled
+  uint32_t getFreeHeap() { return 180000; }
+  uint32_t getMinFreeHeap() { return 150000; }
+  uint32_t getMaxAllocHeap() { return 110000; }
+  uint32_t getHeapSize() { return 300000; }
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getCycleCount() { return (uint32_t)(micros() * 240); }
+  void restart() { exit(0); }
+};
+extern EspClass ESP;
+
+// FreeRTOS - single threaded on the host
+typedef int esp_err_t;
+#define ESP_OK 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffffu
+#define pdMS_TO_TICKS(x) ((TickType_t)(x))
+#define portTICK_PERIOD_MS 1
+#define portYIELD_FROM_ISR(...)
+typedef void *TaskHandle_t;
+typedef void *QueueHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+BaseType_t xTaskCreatePinnedToCore(void (*fn)(void *), const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
+
+void configTime(long gmtOffset, int dstOffset, const char *server1, const char *server2 = nullptr,
+                const char *server3 = nullptr);
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+
+#endif // MOCK_ARDUINO_H
@@ -0,0 +1,27 @@
+/*
+ * Host Preferences Shim for Weather Display Benchmarks
+ *
+ * In-memory NVS: namespaces and keys live in a map for the process lifetime.
+ */
+
+#ifndef MOCK_PREFERENCES_H
+#define MOCK_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences
+{
+public:
+  bool begin(const char *name, bool readOnly = false);
+  void end() {}
+  size_t putBytes(const char *key, const void *value, size_t len);
+  size_t getBytes(const char *key, void *buf, size_t maxLen);
+  size_t getBytesLength(const char *key);
+  bool remove(const char *key);
+
+private:
+  std::string space;
+  bool readOnly = false;
+};
+
+#endif // MOCK_PREFERENCES_H
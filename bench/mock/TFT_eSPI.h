@@ -0,0 +1,536 @@
+/*
+ * Host TFT_eSPI Shim for Weather Display Benchmarks
+ *
+ * TFT_eSPI and TFT_eSprite with the calls the firmware makes. Sprites are
+ * real in-memory framebuffers (4, 8 or 16 bpp) so code that touches the
+ * buffer directly (icon blits, DMA conversion) runs unchanged. Every
+ * object counts primitives, pixels written, glyphs and pixels pushed.
+ * Fonts are modelled as fixed-size cells, so text cost is an estimate.
+ */
+
+#ifndef MOCK_TFT_ESPI_H
+#define MOCK_TFT_ESPI_H
+
+#include <Arduino.h>
+
+#define TFT_BLACK 0x0000
+#define TFT_WHITE 0xFFFF
+#define TFT_RED 0xF800
+#define TFT_GREEN 0x07E0
+#define TFT_BLUE 0x001F
+#define TFT_YELLOW 0xFFE0
+#define TFT_MAGENTA 0xF81F
+#define TFT_CYAN 0x07FF
+#define TFT_ORANGE 0xFDA0
+#define TFT_DARKGREY 0x7BEF
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define CL_DATUM 3
+#define MC_DATUM 4
+#define CC_DATUM 4
+#define MR_DATUM 5
+#define CR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+struct DrawStats
+{
+  uint32_t primitives = 0;
+  uint64_t pixels = 0; // Pixels written (after clipping)
+  uint32_t glyphs = 0;
+  uint64_t pushed = 0; // Pixels sent to the panel
+};
+
+class TFT_eSPI : public Print
+{
+public:
+  DrawStats stats;
+
+  TFT_eSPI(int16_t w = 240, int16_t h = 320) : panelW(w), panelH(h) { resetViewport(); }
+  virtual ~TFT_eSPI() {}
+
+  void init() {}
+  void setRotation(uint8_t r)
+  {
+    if ((r & 1) != (rotation & 1))
+      std::swap(panelW, panelH);
+    rotation = r;
+    resetViewport();
+  }
+  void invertDisplay(bool) {}
+  void writecommand(uint8_t) {}
+  void startWrite() {}
+  void endWrite() {}
+  void setSwapBytes(bool swap) { swapBytes = swap; }
+  bool getSwapBytes() { return swapBytes; }
+
+  // With a viewport datum these report the viewport size, as TFT_eSPI does
+  int16_t width() { return vpDatum ? xWidth : panelW; }
+  int16_t height() { return vpDatum ? yHeight : panelH; }
+
+  // Viewport: clip to (x, y, w, h); with vpDatum, coordinates are relative to (x, y)
+  void setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool datum = true)
+  {
+    xDatum = datum ? x : 0;
+    yDatum = datum ? y : 0;
+    xWidth = datum ? w : panelW;
+    yHeight = datum ? h : panelH;
+    vpDatum = datum;
+    if (x < 0)
+    {
+      w += x;
+      x = 0;
+    }
+    if (y < 0)
+    {
+      h += y;
+      y = 0;
+    }
+    w = min(w, panelW - x);
+    h = min(h, panelH - y);
+    vpX = x;
+    vpY = y;
+    vpW = max(0, w);
+    vpH = max(0, h);
+  }
+  void resetViewport()
+  {
+    vpDatum = false;
+    xDatum = yDatum = 0;
+    vpX = vpY = 0;
+    vpW = panelW;
+    vpH = panelH;
+  }
+  int32_t getViewportX() { return xDatum; }
+  int32_t getViewportY() { return yDatum; }
+
+  // Colours - same packing as TFT_eSPI
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+  uint8_t color16to8(uint16_t c) { return ((c & 0xE000) >> 8) | ((c & 0x0700) >> 6) | ((c & 0x0018) >> 3); }
+  uint16_t color8to16(uint8_t c)
+  {
+    uint16_t r = (c & 0xE0) >> 5, g = (c & 0x1C) >> 2, b = c & 0x03;
+    return (uint16_t)((r * 31 / 7) << 11 | (g * 63 / 7) << 5 | (b * 31 / 3));
+  }
+
+  // Text state
+  void setTextColor(uint16_t fg) { setTextColor(fg, fg); }
+  void setTextColor(uint16_t fg, uint16_t bg, bool = false)
+  {
+    textcolor = fg;
+    textbgcolor = bg;
+  }
+  void setTextDatum(uint8_t d) { textdatum = d; }
+  uint8_t getTextDatum() { return textdatum; }
+  void setTextFont(uint8_t f) { textfont = f; }
+  void setTextSize(uint8_t s) { textsize = s > 0 ? s : 1; }
+  void setTextPadding(uint16_t) {}
+
+  int16_t textWidth(const char *str) { return textWidth(str, textfont); }
+  int16_t textWidth(const char *str, uint8_t font) { return (int16_t)(strlen(str) * cellWidth(font) * textsize); }
+  int16_t textWidth(const String &str) { return textWidth(str.c_str()); }
+  int16_t fontHeight() { return fontHeight(textfont); }
+  int16_t fontHeight(int16_t font) { return (int16_t)(cellHeight(font) * textsize); }
+
+  int16_t drawString(const String &str, int32_t x, int32_t y) { return drawString(str.c_str(), x, y); }
+  int16_t drawString(const char *str, int32_t x, int32_t y) { return drawString(str, x, y, textfont); }
+  int16_t drawString(const char *str, int32_t x, int32_t y, uint8_t font)
+  {
+    int w = textWidth(str, font);
+    int h = fontHeight(font);
+    int col = textdatum % 3;
+    int row = textdatum / 3;
+    x -= col == 1 ? w / 2 : (col == 2 ? w : 0);
+    y -= row == 1 ? h / 2 : (row == 2 ? h : 0);
+    stats.primitives++;
+    stats.glyphs += strlen(str);
+    fillBox(x, y, w, h, textcolor);
+    return (int16_t)w;
+  }
+  int16_t drawChar(uint16_t, int32_t x, int32_t y, uint8_t font)
+  {
+    char one[2] = {'x', 0};
+    return drawString(one, x, y, font);
+  }
+
+  // Primitives
+  void drawPixel(int32_t x, int32_t y, uint32_t color)
+  {
+    stats.primitives++;
+    span(x, y, 1, color);
+  }
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+  {
+    stats.primitives++;
+    span(x, y, w, color);
+  }
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+  {
+    stats.primitives++;
+    for (int i = 0; i < h; i++)
+      span(x, y + i, 1, color);
+  }
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+  {
+    stats.primitives++;
+    fillBox(x, y, w, h, color);
+  }
+  void fillScreen(uint32_t color)
+  {
+    stats.primitives++;
+    for (int y = vpY; y < vpY + vpH; y++)
+      spanDevice(vpX, y, vpW, color);
+  }
+  void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+  {
+    stats.primitives++;
+    span(x, y, w, color);
+    span(x, y + h - 1, w, color);
+    for (int i = 1; i < h - 1; i++)
+    {
+      span(x, y + i, 1, color);
+      span(x + w - 1, y + i, 1, color);
+    }
+  }
+  void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t, uint32_t color) { fillRect(x, y, w, h, color); }
+  void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t, uint32_t color) { drawRect(x, y, w, h, color); }
+
+  void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+  {
+    stats.primitives++;
+    line(x0, y0, x1, y1, color);
+  }
+
+  // TFT_eSPI's own scanline circle, so host renders match the panel pixel
+  // for pixel (tools built on the mock, like the asset pack, depend on it)
+  void fillCircle(int32_t cx, int32_t cy, int32_t r, uint32_t color)
+  {
+    stats.primitives++;
+    int32_t x = 0;
+    int32_t dx = 1;
+    int32_t dy = r + r;
+    int32_t p = -(r >> 1);
+    span(cx - r, cy, dy + 1, color);
+    while (x < r)
+    {
+      if (p >= 0)
+      {
+        span(cx - x, cy + r, dx, color);
+        span(cx - x, cy - r, dx, color);
+        dy -= 2;
+        p -= dy;
+        r--;
+      }
+      dx += 2;
+      p += dx;
+      x++;
+      span(cx - r, cy + x, dy + 1, color);
+      span(cx - r, cy - x, dy + 1, color);
+    }
+  }
+  void drawCircle(int32_t cx, int32_t cy, int32_t r, uint32_t color)
+  {
+    stats.primitives++;
+    int x = r, y = 0, err = 1 - r;
+    while (x >= y)
+    {
+      const int px[8] = {x, y, -y, -x, -x, -y, y, x};
+      const int py[8] = {y, x, x, y, -y, -x, -x, -y};
+      for (int i = 0; i < 8; i++)
+        span(cx + px[i], cy + py[i], 1, color);
+      y++;
+      if (err < 0)
+        err += 2 * y + 1;
+      else
+        err += 2 * (y - --x) + 1;
+    }
+  }
+
+  // TFT_eSPI's (Adafruit GFX) triangle fill, for the same reason
+  void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+  {
+    stats.primitives++;
+    // Sort by y (y2 >= y1 >= y0)
+    if (y0 > y1)
+    {
+      std::swap(y0, y1);
+      std::swap(x0, x1);
+    }
+    if (y1 > y2)
+    {
+      std::swap(y2, y1);
+      std::swap(x2, x1);
+    }
+    if (y0 > y1)
+    {
+      std::swap(y0, y1);
+      std::swap(x0, x1);
+    }
+    if (y0 == y2)
+    {
+      int32_t a = min(x0, min(x1, x2));
+      int32_t b = max(x0, max(x1, x2));
+      span(a, y0, b - a + 1, color);
+      return;
+    }
+
+    int32_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+    int32_t last = y1 == y2 ? y1 : y1 - 1;
+    int32_t y = y0;
+    for (; y <= last; y++)
+    {
+      int32_t a = x0 + sa / dy01;
+      int32_t b = x0 + sb / dy02;
+      sa += dx01;
+      sb += dx02;
+      if (a > b)
+        std::swap(a, b);
+      span(a, y, b - a + 1, color);
+    }
+    sa = dx12 * (y - y1);
+    sb = dx02 * (y - y0);
+    for (; y <= y2; y++)
+    {
+      int32_t a = x1 + sa / dy12;
+      int32_t b = x0 + sb / dy02;
+      sa += dx12;
+      sb += dx02;
+      if (a > b)
+        std::swap(a, b);
+      span(a, y, b - a + 1, color);
+    }
+  }
+  void drawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+  {
+    stats.primitives++;
+    line(x0, y0, x1, y1, color);
+    line(x1, y1, x2, y2, color);
+    line(x2, y2, x0, y0, color);
+  }
+
+  // Panel output
+  bool initDMA(bool = false) { return true; }
+  void deInitDMA() {}
+  bool dmaBusy() { return false; }
+  void dmaWait() {}
+  void pushImageDMA(int32_t, int32_t, int32_t w, int32_t h, uint16_t *, uint16_t * = nullptr) { stats.pushed += (uint64_t)w * h; }
+  void pushImage(int32_t, int32_t, int32_t w, int32_t h, const uint16_t *) { stats.pushed += (uint64_t)w * h; }
+  void pushImage(int32_t, int32_t, int32_t w, int32_t h, const uint8_t *, bool = true, uint16_t * = nullptr) { stats.pushed += (uint64_t)w * h; }
+
+  size_t write(uint8_t) override { return 1; }
+  using Print::write;
+
+  int32_t textfont = 1;
+  int32_t textsize = 1;
+  uint8_t textdatum = TL_DATUM;
+  uint32_t textcolor = TFT_WHITE, textbgcolor = TFT_BLACK;
+
+protected:
+  int16_t panelW, panelH;
+  uint8_t rotation = 0;
+  bool swapBytes = false;
+
+  // Viewport: datum offset and clip rectangle in device coordinates
+  bool vpDatum = false;
+  int32_t xDatum = 0, yDatum = 0, xWidth = 0, yHeight = 0;
+  int32_t vpX = 0, vpY = 0, vpW = 0, vpH = 0;
+
+  // Write one clipped horizontal run - sprites override to store pixels
+  virtual void spanClipped(int32_t, int32_t, int32_t w, uint32_t) { stats.pushed += w; }
+
+  // Horizontal run in drawing coordinates
+  void span(int32_t x, int32_t y, int32_t w, uint32_t color) { spanDevice(x + xDatum, y + yDatum, w, color); }
+
+  void spanDevice(int32_t x, int32_t y, int32_t w, uint32_t color)
+  {
+    if (y < vpY || y >= vpY + vpH || w <= 0)
+      return;
+    if (x < vpX)
+    {
+      w -= vpX - x;
+      x = vpX;
+    }
+    if (x + w > vpX + vpW)
+      w = vpX + vpW - x;
+    if (w <= 0)
+      return;
+    stats.pixels += w;
+    spanClipped(x, y, w, color);
+  }
+
+  void fillBox(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+  {
+    for (int i = 0; i < h; i++)
+      span(x, y + i, w, color);
+  }
+
+  void line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+  {
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;)
+    {
+      span(x0, y0, 1, color);
+      if (x0 == x1 && y0 == y1)
+        return;
+      int e2 = 2 * err;
+      if (e2 >= dy)
+      {
+        err += dy;
+        x0 += sx;
+      }
+      if (e2 <= dx)
+      {
+        err += dx;
+        y0 += sy;
+      }
+    }
+  }
+
+  // Approximate glyph cells for the built-in fonts
+  static int cellWidth(int font)
+  {
+    switch (font)
+    {
+    case 2:
+      return 8;
+    case 4:
+      return 14;
+    case 6:
+      return 27;
+    case 7:
+      return 32;
+    case 8:
+      return 55;
+    default:
+      return 6;
+    }
+  }
+  static int cellHeight(int font)
+  {
+    switch (font)
+    {
+    case 2:
+      return 16;
+    case 4:
+      return 26;
+    case 6:
+      return 48;
+    case 7:
+      return 48;
+    case 8:
+      return 75;
+    default:
+      return 8;
+    }
+  }
+};
+
+class TFT_eSprite : public TFT_eSPI
+{
+public:
+  explicit TFT_eSprite(TFT_eSPI *parent) : TFT_eSPI(0, 0), parent(parent) {}
+  ~TFT_eSprite() override { deleteSprite(); }
+
+  void *setColorDepth(int8_t bits)
+  {
+    depth = bits;
+    return buffer;
+  }
+  int8_t getColorDepth() { return depth; }
+
+  void *createSprite(int16_t w, int16_t h, uint8_t = 1)
+  {
+    deleteSprite();
+    size_t bytes = depth == 16 ? (size_t)w * h * 2 : (depth == 4 ? ((size_t)w * h + 1) / 2 : (size_t)w * h);
+    buffer = (uint8_t *)calloc(bytes, 1);
+    if (buffer != nullptr)
+    {
+      panelW = w;
+      panelH = h;
+    }
+    resetViewport();
+    return buffer;
+  }
+  void deleteSprite()
+  {
+    free(buffer);
+    buffer = nullptr;
+    panelW = panelH = 0;
+    resetViewport();
+  }
+  bool created() { return buffer != nullptr; }
+
+  // 4 bpp sprites draw with slot numbers; the palette only matters for output
+  void createPalette(const uint16_t *colors, uint8_t count = 16)
+  {
+    for (int c = 0; c < 16 && c < count; c++)
+      palette[c] = colors[c];
+  }
+  void *getPointer() { return buffer; }
+
+  void fillSprite(uint32_t color) { fillScreen(color); }
+
+  void pushSprite(int32_t, int32_t) { parent->stats.pushed += (uint64_t)panelW * panelH; }
+  void pushSprite(int32_t x, int32_t y, uint16_t) { pushSprite(x, y); }
+  bool pushSprite(int32_t, int32_t, int32_t, int32_t, int32_t sw, int32_t sh)
+  {
+    parent->stats.pushed += (uint64_t)sw * sh;
+    return true;
+  }
+
+  uint16_t readPixel(int32_t x, int32_t y)
+  {
+    if (buffer == nullptr || x < 0 || y < 0 || x >= panelW || y >= panelH)
+      return 0;
+    if (depth == 16)
+      return ((uint16_t *)buffer)[y * panelW + x];
+    if (depth == 4)
+    {
+      uint8_t pair = buffer[(y * panelW + x) / 2];
+      return palette[(x & 1) ? pair & 0x0F : pair >> 4];
+    }
+    return color8to16(buffer[y * panelW + x]);
+  }
+
+private:
+  TFT_eSPI *parent;
+  int8_t depth = 16;
+  uint8_t *buffer = nullptr;
+  uint16_t palette[16] = {};
+
+  void spanClipped(int32_t x, int32_t y, int32_t w, uint32_t color) override
+  {
+    if (buffer == nullptr)
+      return;
+    if (depth == 16)
+    {
+      // Stored byte-swapped, like TFT_eSprite
+      uint16_t *row = (uint16_t *)buffer + y * panelW + x;
+      std::fill(row, row + w, (uint16_t)((color >> 8) | (color << 8)));
+    }
+    else if (depth == 8)
+    {
+      memset(buffer + y * panelW + x, color16to8(color), w);
+    }
+    else if (depth == 4)
+    {
+      // Left pixel of each pair in the high nibble, as TFT_eSprite packs them
+      uint8_t *row = buffer + (y * panelW) / 2;
+      uint8_t c = color & 0x0F;
+      for (int px = x; px < x + w; px++)
+      {
+        uint8_t &pair = row[px >> 1];
+        pair = (px & 1) ? (pair & 0xF0) | c : (pair & 0x0F) | (c << 4);
+      }
+    }
+  }
+};
+
+#endif // MOCK_TFT_ESPI_H
@@ -0,0 +1,133 @@
+/*
+ * Host WiFi Shim for Weather Display Benchmarks
+ *
+ * A WiFi that is always associated, plus the Client base and a WiFiClient
+ * that answers every request with the payload set by mock::serve(), framed
+ * as an HTTP/1.1 keep-alive response with a Content-Length, so the real
+ * connection header and body code runs against it. Events are never raised.
+ */
+
+#ifndef MOCK_WIFI_H
+#define MOCK_WIFI_H
+
+#include <Arduino.h>
+#include <functional>
+#include <string>
+
+namespace mock
+{
+  // Body returned to the next requests
+  void serve(const std::string &payload);
+  const std::string &response();
+}
+
+typedef enum
+{
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL,
+  WL_SCAN_COMPLETED,
+  WL_CONNECTED,
+  WL_CONNECT_FAILED,
+  WL_CONNECTION_LOST,
+  WL_DISCONNECTED
+} wl_status_t;
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+
+typedef enum
+{
+  ARDUINO_EVENT_WIFI_STA_START,
+  ARDUINO_EVENT_WIFI_STA_CONNECTED,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP
+} arduino_event_id_t;
+typedef union
+{
+  struct
+  {
+    uint8_t reason;
+  } wifi_sta_disconnected;
+} arduino_event_info_t;
+
+class Client : public Stream
+{
+public:
+  virtual uint8_t connected() = 0;
+  virtual void stop() = 0;
+};
+
+class WiFiClient : public Client
+{
+public:
+  int connect(IPAddress, uint16_t)
+  {
+    open = true;
+    return 1;
+  }
+  uint8_t connected() override { return open; }
+  void stop() override { open = false; }
+
+  // A request (one write per request) queues the whole response
+  size_t write(const uint8_t *, size_t n) override
+  {
+    reply = &mock::response();
+    pos = 0;
+    return n;
+  }
+  size_t write(uint8_t) override { return 1; }
+  using Print::write;
+
+  int available() override { return reply != nullptr ? (int)(reply->size() - pos) : 0; }
+  int read() override { return available() > 0 ? (uint8_t)(*reply)[pos++] : -1; }
+  int peek() override { return available() > 0 ? (uint8_t)(*reply)[pos] : -1; }
+
+protected:
+  bool open = false;
+
+private:
+  const std::string *reply = nullptr;
+  size_t pos = 0;
+};
+
+class WiFiClass
+{
+public:
+  wl_status_t status() { return WL_CONNECTED; }
+  void mode(int) {}
+  void persistent(bool) {}
+  wl_status_t begin(const char *, const char * = nullptr, int32_t = 0, const uint8_t * = nullptr, bool = true)
+  {
+    return WL_CONNECTED;
+  }
+  bool config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress()) { return true; }
+  bool disconnect(bool = false, bool = false) { return true; }
+  bool setAutoReconnect(bool) { return true; }
+  IPAddress localIP() { return IPAddress(192, 168, 1, 50); }
+  IPAddress gatewayIP() { return IPAddress(192, 168, 1, 1); }
+  IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+  IPAddress dnsIP(uint8_t = 0) { return IPAddress(192, 168, 1, 1); }
+  uint8_t *BSSID()
+  {
+    static uint8_t bssid[6] = {2, 0, 0, 0, 0, 1};
+    return bssid;
+  }
+  int32_t channel() { return 6; }
+  int8_t RSSI() { return -50; }
+  int hostByName(const char *, IPAddress &ip)
+  {
+    ip = IPAddress(127, 0, 0, 1);
+    return 1;
+  }
+  size_t onEvent(std::function<void(arduino_event_id_t, arduino_event_info_t)>,
+                 arduino_event_id_t = ARDUINO_EVENT_WIFI_STA_START)
+  {
+    return 0;
+  }
+};
+extern WiFiClass WiFi;
+
+static const IPAddress INADDR_NONE(0u);
+
+#endif // MOCK_WIFI_H
@@ -0,0 +1,27 @@
+/*
+ * Host WiFiClientSecure Shim for Weather Display Benchmarks
+ *
+ * The mock WiFiClient with the TLS setup calls accepted and ignored -
+ * responses come from mock::serve() either way.
+ */
+
+#ifndef MOCK_WIFI_CLIENT_SECURE_H
+#define MOCK_WIFI_CLIENT_SECURE_H
+
+#include <WiFi.h>
+
+class WiFiClientSecure : public WiFiClient
+{
+public:
+  void setCACert(const char *) {}
+  void setInsecure() {}
+  void setHandshakeTimeout(unsigned long) {}
+
+  int connect(IPAddress, uint16_t, const char *, const char *, const char *, const char *)
+  {
+    open = true;
+    return 1;
+  }
+};
+
+#endif // MOCK_WIFI_CLIENT_SECURE_H
@@ -0,0 +1,7 @@
+/*
+ * Placeholder credentials for the host benchmark - nothing connects
+ */
+
+#define WIFI_SSID "bench"
+#define WIFI_PASSWORD "bench"
+#define OWM_API_KEY "bench"
@@ -0,0 +1,20 @@
+/*
+ * Host Heap Capabilities Shim for Weather Display Benchmarks
+ *
+ * Capability-tagged allocations come from the normal heap.
+ */
+
+#ifndef MOCK_ESP_HEAP_CAPS_H
+#define MOCK_ESP_HEAP_CAPS_H
+
+#include <Arduino.h>
+
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+
+inline void *heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+inline void heap_caps_free(void *ptr) { free(ptr); }
+inline size_t heap_caps_get_largest_free_block(uint32_t) { return ESP.getMaxAllocHeap(); }
+
+#endif // MOCK_ESP_HEAP_CAPS_H
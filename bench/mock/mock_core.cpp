@@ -0,0 +1,175 @@
+/*
+ * Host Arduino Core Shim for Weather Display Benchmarks
+ *
+ * Definitions behind the mock headers: clock, timing, FreeRTOS no-ops,
+ * CRC, in-memory NVS and the canned HTTP response.
+ */
+
+#include <chrono>
+#include <map>
+#include <thread>
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include <Preferences.h>
+#include <rom/crc.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+namespace mock
+{
+  time_t clock = 0;
+  bool serialEcho = false;
+
+  static std::string httpResponse;
+
+  void serve(const std::string &payload)
+  {
+    httpResponse = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                   std::to_string(payload.size()) + "\r\nConnection: keep-alive\r\n\r\n" + payload;
+  }
+
+  const std::string &response() { return httpResponse; }
+}
+
+#undef time
+time_t mockTime(time_t *out)
+{
+  if (out != nullptr)
+    *out = mock::clock;
+  return mock::clock;
+}
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros()
+{
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(unsigned us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+void yield() {}
+
+void pinMode(int, int) {}
+int digitalRead(int) { return HIGH; }
+void digitalWrite(int, int) {}
+void attachInterrupt(int, void (*)(), int) {}
+void attachInterruptArg(int, void (*)(void *), void *, int) {}
+void detachInterrupt(int) {}
+
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) { return max > min ? min + rand() % (max - min) : min; }
+void randomSeed(unsigned long seed) { srand(seed); }
+uint32_t esp_random() { return ((uint32_t)rand() << 16) ^ (uint32_t)rand(); }
+
+// FreeRTOS - the benchmark runs everything on one thread
+BaseType_t xTaskCreatePinnedToCore(void (*)(void *), const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *handle,
+                                   BaseType_t)
+{
+  if (handle != nullptr)
+    *handle = nullptr;
+  return pdPASS;
+}
+TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t *) {}
+QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t) { return nullptr; }
+BaseType_t xQueueSendFromISR(QueueHandle_t, const void *, BaseType_t *) { return pdFALSE; }
+BaseType_t xQueueReceive(QueueHandle_t, void *, TickType_t) { return pdFALSE; }
+
+void configTime(long, int, const char *, const char *, const char *) {}
+
+bool getLocalTime(struct tm *info, uint32_t)
+{
+  if (mock::clock < 1000000000)
+    return false;
+  localtime_r(&mock::clock, info);
+  return true;
+}
+
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+  size_t len = strlen(src);
+  if (size > 0)
+  {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+
+size_t strlcat(char *dst, const char *src, size_t size)
+{
+  size_t used = strnlen(dst, size);
+  if (used == size)
+    return size + strlen(src);
+  return used + strlcpy(dst + used, src, size - used);
+}
+#endif
+
+// Reflected CRC-32 (0xEDB88320) with the ROM's pre/post inversion
+uint32_t crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+  crc = ~crc;
+  while (len--)
+  {
+    crc ^= *buf++;
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+  }
+  return ~crc;
+}
+
+// NVS: "namespace/key" -> bytes
+static std::map<std::string, std::string> &nvs()
+{
+  static std::map<std::string, std::string> store;
+  return store;
+}
+
+bool Preferences::begin(const char *name, bool readOnly)
+{
+  space = std::string(name) + "/";
+  this->readOnly = readOnly;
+  return true;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len)
+{
+  if (readOnly)
+    return 0;
+  nvs()[space + key] = std::string((const char *)value, len);
+  return len;
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen)
+{
+  auto it = nvs().find(space + key);
+  if (it == nvs().end() || it->second.size() > maxLen)
+    return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+  auto it = nvs().find(space + key);
+  return it == nvs().end() ? 0 : it->second.size();
+}
+
+bool Preferences::remove(const char *key)
+{
+  return !readOnly && nvs().erase(space + key) > 0;
+}
@@ -0,0 +1,13 @@
+/*
+ * Host ROM CRC Shim for Weather Display Benchmarks
+ */
+
+#ifndef MOCK_ROM_CRC_H
+#define MOCK_ROM_CRC_H
+
+#include <stdint.h>
+
+// Same convention as the ESP32 ROM: pass 0 to start, feed the result back to continue
+uint32_t crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
+
+#endif // MOCK_ROM_CRC_H
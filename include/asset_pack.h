@@ -0,0 +1,310 @@
+/*
+ * Icon Asset Pack for Weather Display
+ *
+ * Weather icons pre-rendered on the host (bench/asset_pack_gen.cpp runs
+ * renderWeatherIcon against the bench mocks) and stored as transparent-run
+ * tiles: one byte per pixel (RGB332, or palette slots with PALETTE_FRAME),
+ * each row a list of (skip, length, pixels) runs. Blits read straight from
+ * wherever the pack sits - mapped flash on the device - and copy opaque
+ * runs with memcpy into 8-bit frames.
+ *
+ * Layout, little-endian:
+ *   AssetPackHeader
+ *   AssetEntry[count]
+ *   tiles - per row: run count, then per run: skip, length, length pixels
+ */
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <rom/crc.h>
+#include "palette.h"
+#include "icon_cache.h"
+
+#define ASSET_PACK_MAGIC 0x50414457 // "WDAP"
+#define ASSET_PACK_FORMAT 1
+
+// What the pixel bytes hold - a pack only fits builds with the same palette
+#define ASSET_COLOR_RGB332 0
+#define ASSET_COLOR_PALETTE 1
+#ifdef PALETTE_FRAME
+#define ASSET_COLOR_MODE ASSET_COLOR_PALETTE
+#else
+#define ASSET_COLOR_MODE ASSET_COLOR_RGB332
+#endif
+
+// Icon sizes drawWeatherIcon() is called with; others fall back to the icon cache
+static const uint8_t ASSET_ICON_SIZES[] = {35, 40, 55};
+
+struct AssetPackHeader
+{
+  uint32_t magic;
+  uint16_t format;   // ASSET_PACK_FORMAT - layout of everything below
+  uint8_t colorMode; // ASSET_COLOR_*
+  uint8_t count;     // Entries
+  uint32_t version;  // Content version; the newest valid pack is used
+  uint32_t size;     // Bytes, header included
+  uint32_t crc;      // crc32_le of the bytes after the header
+};
+
+struct AssetEntry
+{
+  uint8_t cls; // IconClass
+  uint8_t size;
+  uint8_t night;
+  uint8_t half;    // Tile is (2 * half) pixels square, centred on the icon
+  uint32_t offset; // Tile data, from the start of the pack
+};
+
+class AssetPack
+{
+public:
+  // Counters since boot
+  uint32_t hits = 0;
+  uint32_t misses = 0; // Icons not in the pack, left to the icon cache
+
+  explicit AssetPack(TFT_eSPI *tft) : tft(tft) {}
+
+  // Why data isn't a pack this build can draw from, nullptr if it is.
+  // Walks every tile, so blits need no bounds checks afterwards.
+  static const char *check(const uint8_t *data, uint32_t length)
+  {
+    const AssetPackHeader *h = (const AssetPackHeader *)data;
+    if (length < sizeof(AssetPackHeader) || h->magic != ASSET_PACK_MAGIC)
+      return "not an asset pack";
+    if (h->format != ASSET_PACK_FORMAT)
+      return "unknown pack format";
+    if (h->colorMode != ASSET_COLOR_MODE)
+      return "pack built for the other colour mode";
+    if (h->size > length || h->size < sizeof(AssetPackHeader) + h->count * sizeof(AssetEntry))
+      return "bad pack size";
+    if (crc32_le(0, data + sizeof(AssetPackHeader), h->size - sizeof(AssetPackHeader)) != h->crc)
+      return "pack CRC mismatch";
+
+    const AssetEntry *entries = (const AssetEntry *)(h + 1);
+    for (int i = 0; i < h->count; i++)
+    {
+      if (!tileFits(data, h->size, entries[i]))
+        return "tile out of bounds";
+    }
+    return nullptr;
+  }
+
+  // Draw from the pack at data (which must stay readable until close());
+  // false, with the pack closed, if check() rejects it
+  bool open(const uint8_t *data, uint32_t length)
+  {
+    close();
+    if (check(data, length) != nullptr)
+      return false;
+    header = (const AssetPackHeader *)data;
+    entries = (const AssetEntry *)(header + 1);
+    return true;
+  }
+
+  void close()
+  {
+    header = nullptr;
+    entries = nullptr;
+  }
+
+  bool ready() const { return header != nullptr; }
+  uint32_t version() const { return header != nullptr ? header->version : 0; }
+  int icons() const { return header != nullptr ? header->count : 0; }
+
+  // Blit an icon centred on (x, y) into a 4, 8 or 16-bit sprite. False if
+  // the pack doesn't have it, so the caller can draw it another way.
+  bool draw(TFT_eSprite &dst, int code, int x, int y, int size, bool isNight)
+  {
+    if (header == nullptr)
+      return false;
+    int depth = dst.getColorDepth();
+    if (depth != 16 && depth != (ASSET_COLOR_MODE == ASSET_COLOR_PALETTE ? 4 : 8))
+      return false;
+
+    IconClass cls = iconClassFor(code);
+    const AssetEntry *e = find(cls, size, iconNight(cls, isNight));
+    if (e == nullptr)
+    {
+      misses++;
+      return false;
+    }
+    hits++;
+    blit(dst, *e, x, y);
+    return true;
+  }
+
+  void report()
+  {
+    Serial.printf("Asset pack: v%lu, %d icons, %lu hits, %lu misses\n", (unsigned long)version(), icons(),
+                  (unsigned long)hits, (unsigned long)misses);
+  }
+
+  // Encode a dim x dim tile of one byte per pixel, key pixels transparent.
+  // With out null, only counts the bytes it would write.
+  static uint32_t encodeTile(const uint8_t *pixels, int dim, uint8_t key, uint8_t *out)
+  {
+    uint32_t n = 0;
+    for (int row = 0; row < dim; row++)
+    {
+      const uint8_t *p = pixels + row * dim;
+      uint32_t countAt = n++;
+      uint8_t runs = 0;
+      int col = 0;
+      int end = 0; // End of the previous run
+      while (col < dim)
+      {
+        if (p[col] == key)
+        {
+          col++;
+          continue;
+        }
+        int start = col;
+        while (col < dim && p[col] != key && col - start < 255)
+          col++;
+        if (out != nullptr)
+        {
+          out[n] = start - end;
+          out[n + 1] = col - start;
+          memcpy(out + n + 2, p + start, col - start);
+        }
+        n += 2 + (col - start);
+        end = col;
+        runs++;
+      }
+      if (out != nullptr)
+        out[countAt] = runs;
+    }
+    return n;
+  }
+
+private:
+  TFT_eSPI *tft;
+  const AssetPackHeader *header = nullptr;
+  const AssetEntry *entries = nullptr;
+
+  const AssetEntry *find(IconClass cls, int size, bool isNight) const
+  {
+    for (int i = 0; i < header->count; i++)
+    {
+      const AssetEntry &e = entries[i];
+      if (e.cls == cls && e.size == size && e.night == isNight)
+        return &e;
+    }
+    return nullptr;
+  }
+
+  // Whether every run of e's tile stays inside its row and inside the pack
+  static bool tileFits(const uint8_t *data, uint32_t size, const AssetEntry &e)
+  {
+    int dim = 2 * e.half;
+    uint32_t at = e.offset;
+    for (int row = 0; row < dim; row++)
+    {
+      if (at >= size)
+        return false;
+      int runs = data[at++];
+      int col = 0;
+      for (int r = 0; r < runs; r++)
+      {
+        if (at + 2 > size)
+          return false;
+        col += data[at] + data[at + 1];
+        at += 2 + data[at + 1];
+        if (col > dim || at > size)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  // Copy the opaque runs into the frame. Positions follow the sprite's
+  // viewport datum, as in IconCache::blit().
+  void blit(TFT_eSprite &dst, const AssetEntry &e, int x, int y)
+  {
+    void *frame = dst.getPointer();
+    if (frame == nullptr)
+      return;
+
+    int depth = dst.getColorDepth();
+    if (depth == 16 && !lutReady)
+      buildLut();
+
+    const uint8_t *p = (const uint8_t *)header + e.offset;
+    int dim = 2 * e.half;
+    int left = x - e.half + dst.getViewportX();
+    int top = y - e.half + dst.getViewportY();
+    int frameW = dst.width();
+    int frameH = dst.height() + dst.getViewportY();
+
+    for (int row = 0; row < dim; row++)
+    {
+      int runs = *p++;
+      int fy = top + row;
+      bool visible = fy >= 0 && fy < frameH;
+      int col = 0;
+      for (int r = 0; r < runs; r++)
+      {
+        col += p[0];
+        int len = p[1];
+        const uint8_t *pixels = p + 2;
+        p += 2 + len;
+        if (visible)
+        {
+          int from = max(col, -left);
+          int to = min(col + len, frameW - left);
+          if (from < to)
+            copyRun(frame, depth, fy * frameW + left + from, pixels + (from - col), to - from);
+        }
+        col += len;
+      }
+    }
+  }
+
+  void copyRun(void *frame, int depth, int at, const uint8_t *pixels, int len)
+  {
+    if (depth == 8)
+    {
+      memcpy((uint8_t *)frame + at, pixels, len);
+    }
+    else if (depth == 16)
+    {
+      uint16_t *d = (uint16_t *)frame + at;
+      for (int i = 0; i < len; i++)
+        d[i] = lut[pixels[i]];
+    }
+    else
+    {
+      // Two pixels per byte, left pixel in the high nibble
+      uint8_t *d = (uint8_t *)frame;
+      for (int i = 0; i < len; i++)
+      {
+        int fx = at + i;
+        uint8_t &pair = d[fx >> 1];
+        pair = (fx & 1) ? (pair & 0xF0) | pixels[i] : (pair & 0x0F) | (pixels[i] << 4);
+      }
+    }
+  }
+
+  // Pixel byte -> RGB565 in the byte order 16-bit sprites store
+  uint16_t lut[256];
+  bool lutReady = false;
+
+  void buildLut()
+  {
+    for (int c = 0; c < 256; c++)
+    {
+#ifdef PALETTE_FRAME
+      uint16_t color = panelColor(c);
+#else
+      uint16_t color = tft->color8to16(c);
+#endif
+      lut[c] = (color >> 8) | (color << 8);
+    }
+    lutReady = true;
+  }
+};
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,184 @@
+/*
+ * Asset Partition for Weather Display
+ *
+ * Keeps the icon asset pack (asset_pack.h) in the "assets" flash partition
+ * (partitions_assets.csv), apart from the firmware, and draws from it
+ * through esp_partition_mmap - no copy in RAM. The partition holds two
+ * slots. A new pack is written to the one not being drawn from, checked,
+ * and handed to the render loop like a new forecast: published here, taken
+ * on its next pass. At boot the newest valid slot wins.
+ */
+
+#ifndef ASSET_STORE_H
+#define ASSET_STORE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_partition.h>
+#include "asset_pack.h"
+
+class AssetStore
+{
+public:
+  static const uint32_t SLOT_BYTES = 128 * 1024;
+  static const int SLOTS = 2;
+  static const uint32_t SECTOR_BYTES = 4096;
+
+  // Render side: the pack icons are drawn from
+  AssetPack pack;
+
+  // Counters since boot
+  uint32_t installs = 0;
+  uint32_t rejected = 0;
+
+  explicit AssetStore(TFT_eSPI *tft) : pack(tft) {}
+
+  // Map the newest valid pack, false if there is none (icons are then
+  // rendered at runtime as before)
+  bool begin()
+  {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "assets");
+    if (partition == nullptr || partition->size < SLOTS * SLOT_BYTES)
+    {
+      Serial.println("Assets: no assets partition - icons rendered at runtime");
+      return false;
+    }
+
+    int best = -1;
+    uint32_t bestVersion = 0;
+    for (int slot = 0; slot < SLOTS; slot++)
+    {
+      uint32_t version;
+      if (probe(slot, version) == nullptr && (best < 0 || version > bestVersion))
+      {
+        best = slot;
+        bestVersion = version;
+      }
+    }
+    if (best < 0 || !map(best))
+    {
+      Serial.println("Assets: no valid pack - icons rendered at runtime");
+      return false;
+    }
+    Serial.printf("Assets: pack v%lu from slot %d, %d icons\n", (unsigned long)pack.version(), best, pack.icons());
+    return true;
+  }
+
+  // Render loop: switch to a pack installed since the last pass. True if it did.
+  bool take()
+  {
+    int slot = pending.load();
+    if (slot < 0)
+      return false;
+    bool switched = map(slot);
+    pending.store(-1); // Only now may the update side reuse the other slot
+    if (!switched)
+      return false;
+    Serial.printf("Assets: switched to pack v%lu\n", (unsigned long)pack.version());
+    return true;
+  }
+
+  // Version of the pack being drawn from, 0 for none (any task)
+  uint32_t version() const { return shownVersion.load(); }
+
+  // Update side (one task at a time, e.g. the HTTP server): erase the free
+  // slot for a pack of bytes. False if it can't take one now.
+  bool beginUpdate(uint32_t bytes)
+  {
+    if (partition == nullptr || bytes > SLOT_BYTES || pending.load() >= 0)
+      return false;
+    int drawn = shown.load();
+    target = drawn < 0 ? 0 : 1 - drawn;
+    written = 0;
+    expected = bytes;
+    uint32_t erase = (bytes + SECTOR_BYTES - 1) / SECTOR_BYTES * SECTOR_BYTES;
+    return esp_partition_erase_range(partition, target * SLOT_BYTES, erase) == ESP_OK;
+  }
+
+  bool writeUpdate(const void *data, size_t len)
+  {
+    if (written + len > expected)
+      return false;
+    if (esp_partition_write(partition, target * SLOT_BYTES + written, data, len) != ESP_OK)
+      return false;
+    written += len;
+    return true;
+  }
+
+  // Check what was written and publish it to the render loop. Why it was
+  // rejected, or nullptr once it's installed.
+  const char *finishUpdate()
+  {
+    uint32_t version;
+    const char *error = written != expected ? "short upload" : probe(target, version);
+    if (error == nullptr && version <= shownVersion.load())
+      error = "not newer than the installed pack";
+    if (error != nullptr)
+    {
+      rejected++;
+      return error;
+    }
+    installs++;
+    pending.store(target);
+    return nullptr;
+  }
+
+  void report()
+  {
+    if (pack.ready())
+      pack.report();
+    Serial.printf("Asset partition: %lu installed, %lu rejected\n", (unsigned long)installs, (unsigned long)rejected);
+  }
+
+private:
+  const esp_partition_t *partition = nullptr;
+  spi_flash_mmap_handle_t handle = 0;
+  const void *mapped = nullptr;
+  std::atomic<int> shown{-1};   // Slot mapped for the render loop (set by the loop)
+  std::atomic<int> pending{-1}; // Slot installed by the update side, -1 once taken
+  std::atomic<uint32_t> shownVersion{0};
+
+  // Update in progress (owned by the update side)
+  int target = 0;
+  uint32_t written = 0;
+  uint32_t expected = 0;
+
+  // Why slot holds no usable pack, nullptr (and its version) if it does
+  const char *probe(int slot, uint32_t &version)
+  {
+    const void *data;
+    spi_flash_mmap_handle_t h;
+    if (esp_partition_mmap(partition, slot * SLOT_BYTES, SLOT_BYTES, ESP_PARTITION_MMAP_DATA, &data, &h) != ESP_OK)
+      return "slot can't be mapped";
+    const char *error = AssetPack::check((const uint8_t *)data, SLOT_BYTES);
+    version = error == nullptr ? ((const AssetPackHeader *)data)->version : 0;
+    spi_flash_munmap(h);
+    return error;
+  }
+
+  // Draw from slot, unmapping the previous one. On failure the previous
+  // pack stays in use.
+  bool map(int slot)
+  {
+    const void *data;
+    spi_flash_mmap_handle_t h;
+    if (esp_partition_mmap(partition, slot * SLOT_BYTES, SLOT_BYTES, ESP_PARTITION_MMAP_DATA, &data, &h) != ESP_OK)
+      return false;
+    if (!pack.open((const uint8_t *)data, SLOT_BYTES))
+    {
+      spi_flash_munmap(h);
+      if (mapped != nullptr)
+        pack.open((const uint8_t *)mapped, SLOT_BYTES);
+      return false;
+    }
+    if (mapped != nullptr)
+      spi_flash_munmap(handle);
+    handle = h;
+    mapped = data;
+    shown.store(slot);
+    shownVersion.store(pack.version());
+    return true;
+  }
+};
+
+#endif // ASSET_STORE_H
@@ -0,0 +1,118 @@
+/*
+ * Button Input for Weather Display
+ *
+ * GPIO interrupts timestamp every button edge into a lock-free ring, and
+ * the render loop drains it and debounces from the timestamps. Presses made
+ * while the loop is busy (a fetch, a WiFi join, a long render) are still
+ * seen, in order and with the time they happened, and press lengths come
+ * from the edges rather than from when the loop got round to looking.
+ */
+
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// One edge as the interrupt saw it
+struct ButtonEvent
+{
+  uint8_t pin;
+  uint8_t level;
+  uint32_t atMicros;
+};
+
+// Single producer (the GPIO interrupt, on one core) and single consumer
+// (the render loop). No locks or critical sections - the ISR only stores
+// into a free slot and publishes it by moving head.
+template <uint32_t N>
+class EdgeRing
+{
+  static_assert((N & (N - 1)) == 0, "EdgeRing size must be a power of two");
+
+public:
+  uint32_t dropped = 0; // Edges lost to a full ring (written by the producer)
+
+  // Forced inline so the ISR that calls it stays entirely in IRAM
+  __attribute__((always_inline)) inline bool push(const ButtonEvent &event)
+  {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= N)
+    {
+      dropped++;
+      return false;
+    }
+    slots[h & (N - 1)] = event;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(ButtonEvent &event)
+  {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire))
+      return false;
+    event = slots[t & (N - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  ButtonEvent slots[N];
+  std::atomic<uint32_t> head{0};
+  std::atomic<uint32_t> tail{0};
+};
+
+enum ButtonChange
+{
+  BUTTON_NONE,
+  BUTTON_PRESSED,
+  BUTTON_RELEASED
+};
+
+// One button debounced from its edge timestamps. The first edge of a
+// bounce burst counts straight away, so debouncing adds no delay; edges
+// within DEBOUNCE_US of it are bounce. Once the burst is over the button
+// settles on the last level seen, which catches taps shorter than the
+// lockout and bursts that end the other way.
+class DebouncedButton
+{
+public:
+  static const uint32_t DEBOUNCE_US = 30000;
+
+  bool down = false;
+  uint32_t changedAt = 0; // micros() of the last accepted change
+
+  ButtonChange edge(bool isDown, uint32_t at)
+  {
+    rawDown = isDown;
+    rawAt = at;
+    if (isDown == down || at - changedAt < DEBOUNCE_US)
+      return BUTTON_NONE;
+    return accept(isDown, at);
+  }
+
+  // Call after draining the edges; now in micros()
+  ButtonChange settle(uint32_t now)
+  {
+    if (rawDown == down || now - changedAt < DEBOUNCE_US)
+      return BUTTON_NONE;
+    return accept(rawDown, rawAt - changedAt < DEBOUNCE_US ? changedAt + DEBOUNCE_US : rawAt);
+  }
+
+  // Last edge disagrees with the debounced state - settle() is due soon
+  bool settling() const { return rawDown != down; }
+
+private:
+  bool rawDown = false;
+  uint32_t rawAt = 0;
+
+  ButtonChange accept(bool isDown, uint32_t at)
+  {
+    down = isDown;
+    changedAt = at;
+    return isDown ? BUTTON_PRESSED : BUTTON_RELEASED;
+  }
+};
+
+#endif // BUTTON_INPUT_H
@@ -0,0 +1,72 @@
+/*
+ * Counting JSON Allocator for Weather Display
+ *
+ * ArduinoJson allocator that tracks bytes in use, the peak and the number
+ * of allocations, so each fetch (and the host benchmark) can report them.
+ */
+
+#ifndef COUNTING_ALLOCATOR_H
+#define COUNTING_ALLOCATOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Counts the bytes held by a JsonDocument so each fetch can report its peak
+class CountingAllocator : public ArduinoJson::Allocator
+{
+public:
+  size_t inUse = 0;
+  size_t peak = 0;
+  uint32_t allocations = 0; // allocate() + reallocate() calls since reset()
+
+  void reset()
+  {
+    inUse = 0;
+    peak = 0;
+    allocations = 0;
+  }
+
+  void *allocate(size_t size) override
+  {
+    size_t *block = (size_t *)malloc(size + sizeof(size_t));
+    if (block == nullptr)
+      return nullptr;
+    *block = size;
+    track(size, 0);
+    return block + 1;
+  }
+
+  void deallocate(void *ptr) override
+  {
+    if (ptr == nullptr)
+      return;
+    size_t *block = (size_t *)ptr - 1;
+    inUse -= *block;
+    free(block);
+  }
+
+  void *reallocate(void *ptr, size_t newSize) override
+  {
+    if (ptr == nullptr)
+      return allocate(newSize);
+    size_t *block = (size_t *)ptr - 1;
+    size_t oldSize = *block;
+    size_t *resized = (size_t *)realloc(block, newSize + sizeof(size_t));
+    if (resized == nullptr)
+      return nullptr;
+    *resized = newSize;
+    track(newSize, oldSize);
+    return resized + 1;
+  }
+
+private:
+  void track(size_t added, size_t removed)
+  {
+    allocations++;
+    inUse = inUse - removed + added;
+    if (inUse > peak)
+      peak = inUse;
+  }
+};
+
+#endif // COUNTING_ALLOCATOR_H
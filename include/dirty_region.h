@@ -0,0 +1,173 @@
+/*
+ * Dirty Region Tracking for Weather Display
+ *
+ * Records which parts of the frame sprite have changed since the last
+ * push, so only those rectangles are sent over SPI.
+ */
+
+#ifndef DIRTY_REGION_H
+#define DIRTY_REGION_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+struct DirtyRect
+{
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+
+  int32_t area() const { return (int32_t)w * h; }
+};
+
+class DirtyRegion
+{
+public:
+  static const int MAX_RECTS = 4;
+
+  DirtyRegion(int16_t width, int16_t height) : width(width), height(height), count(0) {}
+
+  // Mark an area of the sprite as changed (clipped to the sprite bounds)
+  void mark(int x, int y, int w, int h)
+  {
+    if (x < 0)
+    {
+      w += x;
+      x = 0;
+    }
+    if (y < 0)
+    {
+      h += y;
+      y = 0;
+    }
+    if (x + w > width)
+      w = width - x;
+    if (y + h > height)
+      h = height - y;
+    if (w <= 0 || h <= 0)
+      return;
+
+    DirtyRect r = {(int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h};
+
+    // Fold the new rect into any rects it touches, repeating until stable
+    bool merged = true;
+    while (merged)
+    {
+      merged = false;
+      for (int i = 0; i < count; i++)
+      {
+        if (touches(rects[i], r))
+        {
+          r = unite(rects[i], r);
+          rects[i] = rects[--count];
+          merged = true;
+          break;
+        }
+      }
+    }
+
+    if (count < MAX_RECTS)
+    {
+      rects[count++] = r;
+      return;
+    }
+
+    // List is full - grow whichever rect the new one adds least area to
+    int best = 0;
+    int32_t bestGrowth = INT32_MAX;
+    for (int i = 0; i < count; i++)
+    {
+      int32_t growth = unite(rects[i], r).area() - rects[i].area();
+      if (growth < bestGrowth)
+      {
+        bestGrowth = growth;
+        best = i;
+      }
+    }
+    rects[best] = unite(rects[best], r);
+  }
+
+  void markAll()
+  {
+    rects[0] = {0, 0, width, height};
+    count = 1;
+  }
+
+  void clear() { count = 0; }
+
+  bool isEmpty() const { return count == 0; }
+
+  // Hand each changed area to push(const DirtyRect &), returns pixels sent
+  template <typename PushFn>
+  uint32_t flushWith(PushFn push)
+  {
+    uint32_t pixels = 0;
+    for (int i = 0; i < count; i++)
+    {
+      push(rects[i]);
+      pixels += rects[i].area();
+    }
+    count = 0;
+    return pixels;
+  }
+
+  // Whether any changed area overlaps rows [y, y + h)
+  bool touchesRows(int y, int h) const
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (rects[i].y < y + h && y < rects[i].y + rects[i].h)
+        return true;
+    }
+    return false;
+  }
+
+  // Hand the part of each changed area within rows [y, y + h) to
+  // visit(const DirtyRect &), leaving the list intact for the next band
+  template <typename VisitFn>
+  void forEachInRows(int y, int h, VisitFn visit) const
+  {
+    for (int i = 0; i < count; i++)
+    {
+      int top = max((int)rects[i].y, y);
+      int bottom = min(rects[i].y + rects[i].h, y + h);
+      if (top < bottom)
+        visit(DirtyRect{rects[i].x, (int16_t)top, rects[i].w, (int16_t)(bottom - top)});
+    }
+  }
+
+  // Push the changed areas of a sprite to the same position on screen
+  uint32_t flush(TFT_eSprite &spr)
+  {
+    return flushWith([&](const DirtyRect &r)
+                 {
+                   if (r.x == 0 && r.y == 0 && r.w == width && r.h == height)
+                     spr.pushSprite(0, 0);
+                   else
+                     spr.pushSprite(r.x, r.y, r.x, r.y, r.w, r.h);
+                 });
+  }
+
+private:
+  int16_t width;
+  int16_t height;
+  DirtyRect rects[MAX_RECTS];
+  int count;
+
+  static bool touches(const DirtyRect &a, const DirtyRect &b)
+  {
+    return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+  }
+
+  static DirtyRect unite(const DirtyRect &a, const DirtyRect &b)
+  {
+    int16_t x0 = min(a.x, b.x);
+    int16_t y0 = min(a.y, b.y);
+    int16_t x1 = max(a.x + a.w, b.x + b.w);
+    int16_t y1 = max(a.y + a.h, b.y + b.h);
+    return {x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+  }
+};
+
+#endif // DIRTY_REGION_H
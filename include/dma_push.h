@@ -0,0 +1,134 @@
+/*
+ * DMA Band Pusher for Weather Display
+ *
+ * Sends areas of the 8-bit (or 4-bit palettized) frame sprite to the
+ * panel over SPI DMA.
+ * Pixels are expanded to 16-bit one band at a time into two ping-pong
+ * buffers, so the next band is converted while the previous one is
+ * still transferring.
+ */
+
+#ifndef DMA_PUSH_H
+#define DMA_PUSH_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <esp_heap_caps.h>
+
+class DmaBandPusher
+{
+public:
+  static const uint32_t BAND_PIXELS = 320 * 16; // 10 KB per buffer at 16 bpp
+
+  // Allocate DMA-capable band buffers and start the SPI DMA channel
+  bool begin(TFT_eSPI &tft)
+  {
+    for (int i = 0; i < 2; i++)
+    {
+      bands[i] = (uint16_t *)heap_caps_malloc(BAND_PIXELS * sizeof(uint16_t), MALLOC_CAP_DMA);
+      if (bands[i] == nullptr)
+      {
+        end();
+        return false;
+      }
+    }
+
+    // RGB332 -> RGB565 lookup, pre-swapped into panel byte order for DMA
+    for (int c = 0; c < 256; c++)
+    {
+      uint16_t color = tft.color8to16(c);
+      lut[c] = (color >> 8) | (color << 8);
+    }
+
+    active = tft.initDMA();
+    if (!active)
+      end();
+    return active;
+  }
+
+  void end()
+  {
+    for (int i = 0; i < 2; i++)
+    {
+      if (bands[i] != nullptr)
+        heap_caps_free(bands[i]);
+      bands[i] = nullptr;
+    }
+    active = false;
+  }
+
+  bool ready() const { return active; }
+
+  // RGB565 colours of a 4-bit sprite's palette slots
+  void setPalette(const uint16_t *colors, int count)
+  {
+    for (int c = 0; c < 16 && c < count; c++)
+      palette[c] = (colors[c] >> 8) | (colors[c] << 8);
+  }
+
+  // Push an area of an 8 or 4-bit sprite to the same position on screen
+  void push(TFT_eSPI &tft, TFT_eSprite &spr, int x, int y, int w, int h)
+  {
+    const uint8_t *src = (const uint8_t *)spr.getPointer();
+    if (src == nullptr || w <= 0 || h <= 0)
+      return;
+
+    int stride = spr.width();
+    bool packed = spr.getColorDepth() == 4;
+    int rowsPerBand = max(1, (int)(BAND_PIXELS / w));
+
+    // Band data is already in panel byte order
+    bool swap = tft.getSwapBytes();
+    tft.setSwapBytes(false);
+    tft.startWrite();
+
+    int buf = 0;
+    for (int row = y; row < y + h; row += rowsPerBand)
+    {
+      int rows = min(rowsPerBand, y + h - row);
+      uint16_t *dst = bands[buf];
+      for (int r = 0; r < rows; r++)
+      {
+        if (packed)
+        {
+          // Two pixels per byte, left pixel in the high nibble - an odd
+          // start or end takes half a byte, everything between whole ones
+          const uint8_t *line = src + (row + r) * stride / 2;
+          int px = x;
+          int end = x + w;
+          if (px & 1)
+            *dst++ = palette[line[px++ >> 1] & 0x0F];
+          for (; px + 1 < end; px += 2)
+          {
+            uint8_t pair = line[px >> 1];
+            *dst++ = palette[pair >> 4];
+            *dst++ = palette[pair & 0x0F];
+          }
+          if (px < end)
+            *dst++ = palette[line[px >> 1] >> 4];
+          continue;
+        }
+        const uint8_t *line = src + (row + r) * stride + x;
+        for (int i = 0; i < w; i++)
+        {
+          *dst++ = lut[line[i]];
+        }
+      }
+      // Waits for the previous band (the other buffer) before queueing this one
+      tft.pushImageDMA(x, row, w, rows, bands[buf]);
+      buf ^= 1;
+    }
+
+    tft.dmaWait();
+    tft.endWrite();
+    tft.setSwapBytes(swap);
+  }
+
+private:
+  uint16_t *bands[2] = {nullptr, nullptr};
+  uint16_t lut[256];
+  uint16_t palette[16] = {}; // 4-bit slots, filled by setPalette() in the same byte order
+  bool active = false;
+};
+
+#endif // DMA_PUSH_H
@@ -0,0 +1,57 @@
+/*
+ * Duty Cycle Meter for Weather Display
+ *
+ * Splits wall time into busy, idle (delay) and light-sleep time for the
+ * display-on and display-off modes, and prints a summary on request.
+ * There's no current sensor on the board, so duty cycle stands in for
+ * power draw.
+ */
+
+#ifndef DUTY_CYCLE_H
+#define DUTY_CYCLE_H
+
+#include <Arduino.h>
+
+class DutyCycleMeter
+{
+public:
+  enum Mode
+  {
+    MODE_DISPLAY_ON,
+    MODE_DISPLAY_OFF,
+    MODE_COUNT
+  };
+
+  void busy(Mode mode, unsigned long us) { stats[mode].busyUs += us; }
+  void idle(Mode mode, unsigned long us) { stats[mode].idleUs += us; }
+  void slept(Mode mode, unsigned long us) { stats[mode].sleepUs += us; }
+
+  // Print and reset the per-mode breakdown
+  void report()
+  {
+    static const char *const names[MODE_COUNT] = {"display on", "display off"};
+    for (int m = 0; m < MODE_COUNT; m++)
+    {
+      Stats &s = stats[m];
+      uint64_t total = s.busyUs + s.idleUs + s.sleepUs;
+      if (total == 0)
+        continue;
+      Serial.printf("Duty cycle [%s]: busy %.1f%%, idle %.1f%%, light sleep %.1f%% over %lu s\n",
+                    names[m], 100.0 * s.busyUs / total, 100.0 * s.idleUs / total,
+                    100.0 * s.sleepUs / total, (unsigned long)(total / 1000000));
+      s = Stats();
+    }
+  }
+
+private:
+  struct Stats
+  {
+    uint64_t busyUs = 0;
+    uint64_t idleUs = 0;
+    uint64_t sleepUs = 0;
+  };
+
+  Stats stats[MODE_COUNT];
+};
+
+#endif // DUTY_CYCLE_H
@@ -0,0 +1,60 @@
+/*
+ * Fixed-Point Helpers for Weather Display
+ *
+ * Q16.16 arithmetic for draw math. The ESP32 has no double-precision FPU,
+ * so geometry like "r * 0.35" is cheaper as an integer multiply with a
+ * constant that folds at compile time, e.g. scaleInt(r, toFixed(0.35)).
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+typedef int32_t fixed_t; // Q16.16
+
+constexpr int FIXED_SHIFT = 16;
+constexpr fixed_t FIXED_ONE = (fixed_t)1 << FIXED_SHIFT;
+
+// Convert a constant to Q16.16, rounding to nearest
+constexpr fixed_t toFixed(double v)
+{
+  return (fixed_t)(v * FIXED_ONE + (v >= 0 ? 0.5 : -0.5));
+}
+
+constexpr fixed_t intToFixed(int v)
+{
+  return (fixed_t)v * FIXED_ONE;
+}
+
+// Floor to int - matches the truncation of the old float casts for
+// positive screen coordinates
+constexpr int fixedToInt(fixed_t v)
+{
+  return v >> FIXED_SHIFT;
+}
+
+constexpr int fixedRound(fixed_t v)
+{
+  return (v + (FIXED_ONE >> 1)) >> FIXED_SHIFT;
+}
+
+constexpr fixed_t fixedMul(fixed_t a, fixed_t b)
+{
+  return (fixed_t)(((int64_t)a * b) >> FIXED_SHIFT);
+}
+
+// Integer times fraction, floored - e.g. scaleInt(r, toFixed(0.35)).
+// Stays in 32 bits for |v| < 32768 with |k| <= 1.0.
+constexpr int scaleInt(int v, fixed_t k)
+{
+  return fixedToInt(v * k);
+}
+
+// origin + unit * length, floored as a whole like (int)(x + cos(a) * len)
+constexpr int offsetBy(int origin, fixed_t unit, int length)
+{
+  return fixedToInt(intToFixed(origin) + unit * length);
+}
+
+#endif // FIXED_POINT_H
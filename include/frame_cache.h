@@ -0,0 +1,197 @@
+/*
+ * Static Frame Cache for Weather Display
+ *
+ * Finished frames of screens that show no data (About, the demos), kept
+ * PackBits-compressed within a fixed byte budget so going back to one is
+ * a decompress into the frame sprite instead of a full redraw. Mostly
+ * background, they shrink to a few KB each. Frames that don't fit are
+ * simply not cached: screens are toured in a fixed cycle, where evicting
+ * the least recently used frame would always drop the next one needed.
+ */
+
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+class FrameCache
+{
+public:
+  static const uint32_t BUDGET_BYTES = 32 * 1024;
+  static const int MAX_ENTRIES = 6;
+
+  // Counters since boot
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+
+  // Copy frame id into the sprite. False (sprite untouched) if it isn't
+  // cached for this sprite's size and depth.
+  bool restore(int id, TFT_eSprite &frame)
+  {
+    uint8_t *pixels = (uint8_t *)frame.getPointer();
+    Entry *e = find(id, frameBytes(frame));
+    if (e == nullptr || pixels == nullptr)
+    {
+      misses++;
+      return false;
+    }
+    unpack(e->data, e->size, pixels, e->frameBytes);
+    hits++;
+    return true;
+  }
+
+  // Keep the sprite's current contents as frame id
+  void store(int id, TFT_eSprite &frame)
+  {
+    const uint8_t *pixels = (const uint8_t *)frame.getPointer();
+    uint32_t raw = frameBytes(frame);
+    if (pixels == nullptr || raw == 0)
+      return;
+    uint32_t bytes = pack(pixels, raw, nullptr);
+    if (bytes > BUDGET_BYTES)
+      return;
+
+    Entry *slot = find(id, raw);
+    if (slot != nullptr)
+      release(*slot);
+    slot = freeSlot();
+    if (slot == nullptr || bytesUsed + bytes > BUDGET_BYTES)
+      return;
+
+    slot->data = (uint8_t *)malloc(bytes);
+    if (slot->data == nullptr)
+      return;
+    pack(pixels, raw, slot->data);
+    slot->used = true;
+    slot->id = id;
+    slot->size = bytes;
+    slot->frameBytes = raw;
+    bytesUsed += bytes;
+  }
+
+  // Drop every frame - call when something they show is drawn differently
+  void clear()
+  {
+    for (int i = 0; i < MAX_ENTRIES; i++)
+      release(entries[i]);
+  }
+
+  void report()
+  {
+    Serial.printf("Frame cache: %lu bytes, %lu hits, %lu misses\n", (unsigned long)bytesUsed, (unsigned long)hits,
+                  (unsigned long)misses);
+  }
+
+private:
+  struct Entry
+  {
+    bool used = false;
+    int id = 0;
+    uint8_t *data = nullptr;
+    uint32_t size = 0;       // Compressed bytes
+    uint32_t frameBytes = 0; // Sprite buffer size it was taken from
+  };
+
+  Entry entries[MAX_ENTRIES];
+  uint32_t bytesUsed = 0;
+
+  static uint32_t frameBytes(TFT_eSprite &frame)
+  {
+    return (uint32_t)frame.width() * frame.height() * frame.getColorDepth() / 8;
+  }
+
+  Entry *find(int id, uint32_t raw)
+  {
+    for (int i = 0; i < MAX_ENTRIES; i++)
+    {
+      if (entries[i].used && entries[i].id == id && entries[i].frameBytes == raw)
+        return &entries[i];
+    }
+    return nullptr;
+  }
+
+  Entry *freeSlot()
+  {
+    for (int i = 0; i < MAX_ENTRIES; i++)
+    {
+      if (!entries[i].used)
+        return &entries[i];
+    }
+    return nullptr;
+  }
+
+  void release(Entry &e)
+  {
+    if (!e.used)
+      return;
+    free(e.data);
+    e.data = nullptr;
+    bytesUsed -= e.size;
+    e.used = false;
+  }
+
+  // PackBits: a control byte n < 128 is followed by n + 1 literal bytes;
+  // 128 and up repeats the next byte n - 126 times (2..129). With out null,
+  // only counts the bytes it would write.
+  static uint32_t pack(const uint8_t *src, uint32_t len, uint8_t *out)
+  {
+    uint32_t n = 0;
+    uint32_t i = 0;
+    while (i < len)
+    {
+      uint32_t run = 1;
+      while (i + run < len && run < 129 && src[i + run] == src[i])
+        run++;
+      if (run >= 2)
+      {
+        if (out != nullptr)
+        {
+          out[n] = run + 126;
+          out[n + 1] = src[i];
+        }
+        n += 2;
+        i += run;
+        continue;
+      }
+
+      // Literals up to the next run of two or more
+      uint32_t lit = 1;
+      while (i + lit < len && lit < 128 && !(i + lit + 1 < len && src[i + lit] == src[i + lit + 1]))
+        lit++;
+      if (out != nullptr)
+      {
+        out[n] = lit - 1;
+        memcpy(out + n + 1, src + i, lit);
+      }
+      n += 1 + lit;
+      i += lit;
+    }
+    return n;
+  }
+
+  static void unpack(const uint8_t *src, uint32_t len, uint8_t *out, uint32_t outLen)
+  {
+    uint32_t i = 0;
+    uint32_t o = 0;
+    while (i < len && o < outLen)
+    {
+      uint8_t c = src[i++];
+      if (c < 128)
+      {
+        uint32_t lit = min((uint32_t)c + 1, outLen - o);
+        memcpy(out + o, src + i, lit);
+        i += c + 1;
+        o += lit;
+      }
+      else
+      {
+        uint32_t run = min((uint32_t)c - 126, outLen - o);
+        memset(out + o, src[i++], run);
+        o += run;
+      }
+    }
+  }
+};
+
+#endif // FRAME_CACHE_H
@@ -0,0 +1,131 @@
+/*
+ * Frame Diffing for Weather Display
+ *
+ * Keeps a hash of every tile of the frame last sent to the panel. Before
+ * a push the tiles inside the dirty areas are hashed again, and only the
+ * ones whose pixels actually changed stay dirty - a refresh that redraws
+ * the same screen with the same numbers pushes nothing.
+ */
+
+#ifndef FRAME_DIFF_H
+#define FRAME_DIFF_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "dirty_region.h"
+
+class FrameDiff
+{
+public:
+  // Frame dimensions must be multiples of the tile size
+  static const int TILE_W = 32;
+  static const int TILE_H = 24;
+  static const int MAX_TILES = (320 / TILE_W) * (240 / TILE_H);
+
+  // Counters since the last report()
+  uint32_t frames = 0;
+  uint32_t skipped = 0; // Frames with no changed tile, never pushed
+  uint32_t tilesHashed = 0;
+  uint32_t tilesChanged = 0;
+
+  FrameDiff(int16_t width, int16_t height) : cols(width / TILE_W), rows(height / TILE_H) {}
+
+  // The panel no longer shows the last pushed frame (drawn to directly) -
+  // the next push sends the whole frame
+  void invalidate() { valid = false; }
+
+  // Cut dirty down to the tiles whose contents differ from the last push.
+  // Returns false when nothing changed and the push can be skipped.
+  bool narrow(TFT_eSprite &spr, DirtyRegion &dirty)
+  {
+    const uint8_t *frame = (const uint8_t *)spr.getPointer();
+    if (frame == nullptr || cols * rows > MAX_TILES)
+      return !dirty.isEmpty();
+
+    frames++;
+    int depth = spr.getColorDepth();
+    int stride = spr.width() * depth / 8;
+    int tileBytes = TILE_W * depth / 8;
+
+    // Before the first push every tile is unknown, so hash and send them all
+    bool full = !valid;
+    if (full)
+      dirty.markAll();
+
+    bool touched[MAX_TILES] = {};
+    dirty.forEachInRows(0, rows * TILE_H, [&](const DirtyRect &r)
+                        {
+                          for (int ty = r.y / TILE_H; ty <= (r.y + r.h - 1) / TILE_H; ty++)
+                            for (int tx = r.x / TILE_W; tx <= (r.x + r.w - 1) / TILE_W; tx++)
+                              touched[ty * cols + tx] = true;
+                        });
+
+    DirtyRegion changed(cols * TILE_W, rows * TILE_H);
+    for (int ty = 0; ty < rows; ty++)
+    {
+      int runStart = -1; // First changed tile of the current run in this row
+      for (int tx = 0; tx <= cols; tx++)
+      {
+        bool differs = false;
+        if (tx < cols && touched[ty * cols + tx])
+        {
+          tilesHashed++;
+          uint32_t h = hashTile(frame + ty * TILE_H * stride + tx * tileBytes, stride, tileBytes);
+          uint32_t &last = hashes[ty * cols + tx];
+          differs = full || h != last;
+          last = h;
+        }
+        if (differs)
+        {
+          tilesChanged++;
+          if (runStart < 0)
+            runStart = tx;
+        }
+        else if (runStart >= 0)
+        {
+          changed.mark(runStart * TILE_W, ty * TILE_H, (tx - runStart) * TILE_W, TILE_H);
+          runStart = -1;
+        }
+      }
+    }
+
+    valid = true;
+    dirty = changed;
+    if (dirty.isEmpty())
+    {
+      skipped++;
+      return false;
+    }
+    return true;
+  }
+
+  void report()
+  {
+    if (frames == 0)
+      return;
+    Serial.printf("Frame diff: %lu frames, %lu unchanged, %lu of %lu hashed tiles pushed\n", (unsigned long)frames,
+                  (unsigned long)skipped, (unsigned long)tilesChanged, (unsigned long)tilesHashed);
+    frames = skipped = tilesHashed = tilesChanged = 0;
+  }
+
+private:
+  int cols;
+  int rows;
+  bool valid = false;
+  uint32_t hashes[MAX_TILES];
+
+  // FNV-1a over 32-bit words - tile rows are word aligned at every depth
+  static uint32_t hashTile(const uint8_t *first, int stride, int rowBytes)
+  {
+    uint32_t h = 2166136261u;
+    for (int row = 0; row < TILE_H; row++)
+    {
+      const uint32_t *word = (const uint32_t *)(first + row * stride);
+      for (int i = 0; i < rowBytes / 4; i++)
+        h = (h ^ word[i]) * 16777619u;
+    }
+    return h;
+  }
+};
+
+#endif // FRAME_DIFF_H
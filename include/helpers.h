@@ -2,7 +2,7 @@
  * Helper Functions for Weather Display
  *
  * Utility functions for temperature colors, compass directions,
- * UV index handling, time formatting, and text wrapping.
+ * UV index handling and day names.
  */
 
 #ifndef HELPERS_H
@@ -11,27 +11,32 @@
 #include <Arduino.h>
 #include <TFT_eSPI.h>
 #include "types.h"
+#include "palette.h"
 
 // External references to globals defined in main.cpp
 extern TFT_eSPI tft;
 extern TFT_eSprite sprite;
-extern WeatherData weather;
-
-// Color constants (must match main.cpp)
-#define COLOR_BG 0x0000
-#define COLOR_TEXT 0xD69A
-#define COLOR_SUBTLE 0x8410
-#define COLOR_SUN 0xFE60
-#define COLOR_SUCCESS 0x3666
-#define COLOR_ACCENT 0xFD20
-
-// Convert wind degrees to compass direction
-inline String degToCompass(int deg)
+extern const WeatherData *weather;
+
+// Convert wind degrees to compass direction (points into a static table).
+// Any angle is wrapped into 0..359 first, so out-of-range input can't index
+// outside the table.
+inline const char *degToCompass(int deg)
 {
-  const char *dirs[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
-                        "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
+  static const char *const dirs[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
+                                     "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
+  deg %= 360;
+  if (deg < 0)
+    deg += 360;
   int index = ((deg + 11) / 22) % 16;
-  return String(dirs[index]);
+  return dirs[index];
+}
+
+// Short day name for tm_wday (points into a static table)
+inline const char *shortDayName(int wday)
+{
+  static const char *const days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+  return days[wday % 7];
 }
 
 // Check if current time is between sunrise and sunset
@@ -40,113 +45,106 @@ inline bool isDaytime()
   time_t now = time(NULL);
   if (now < 1000000000)
     return true; // Default to day if time not synced
-  return (now >= weather.sunrise && now < weather.sunset);
+  return (now >= weather->sunrise && now < weather->sunset);
 }
 
-// Format time_t to readable string (e.g., "06:45 am")
-inline String formatWeatherTime(time_t rawTime)
+// Temperature colour table: TEMP_LUT_STEPS steps per degree from
+// TEMP_LUT_MIN to TEMP_LUT_MAX, built at compile time. Both ends are
+// already saturated (blue at 15 and below, orange from 40).
+#define TEMP_LUT_MIN -10
+#define TEMP_LUT_MAX 50
+#define TEMP_LUT_STEPS 2
+#define TEMP_LUT_SIZE ((TEMP_LUT_MAX - TEMP_LUT_MIN) * TEMP_LUT_STEPS + 1)
+
+// Colour for a temperature: blue (cold) -> white (neutral) -> orange (hot).
+// Evaluated only at compile time, to fill the table.
+constexpr uint16_t tempColorAt(double temp)
 {
-  struct tm *timeinfo = localtime(&rawTime);
-  char buffer[10];
-  strftime(buffer, sizeof(buffer), "%I:%M %p", timeinfo);
-  return String(buffer);
+  if (temp <= 15)
+    return COLOR_RAIN;
+  if (temp >= 40)
+    return COLOR_ACCENT;
+  if (temp >= 24 && temp <= 26)
+    return COLOR_TEXT;
+  if (temp < 24)
+  {
+    // Gradient from blue (15) to white (24)
+    double ratio = (temp - 15.0) / 9.0;
+#ifdef PALETTE_FRAME
+    // Quantized to the nearest of blue, the reserved midpoint and white
+    return ratio < 0.25 ? COLOR_RAIN : (ratio < 0.75 ? COLOR_TEMP_COOL : COLOR_TEXT);
+#else
+    int rg = ratio * 255;
+    return frameColor(rg, rg, 255);
+#endif
+  }
+  // Gradient from white (26) to orange (40)
+  double ratio = (temp - 26.0) / 14.0;
+#ifdef PALETTE_FRAME
+  return ratio < 0.25 ? COLOR_TEXT : (ratio < 0.75 ? COLOR_TEMP_WARM : COLOR_ACCENT);
+#else
+  return frameColor(255, (int)(255 - ratio * 155), (int)(255 - ratio * 255));
+#endif
 }
 
-// Draw text with word wrapping
-inline void drawWrappedString(String text, int x, int y, int maxWidth)
+struct TempColorTable
 {
-  int currentY = y;
-  String word = "";
-  String line = "";
+  uint16_t colors[TEMP_LUT_SIZE];
+};
 
-  for (unsigned int i = 0; i < text.length(); i++)
-  {
-    char c = text[i];
-    if (c == ' ')
-    {
-      // Check if adding the word exceeds maxWidth
-      if (sprite.textWidth(line + word) > maxWidth)
-      {
-        sprite.drawString(line, x, currentY);
-        line = word + " ";
-        currentY += sprite.fontHeight();
-      }
-      else
-      {
-        line += word + " ";
-      }
-      word = "";
-    }
-    else
-    {
-      word += c;
-    }
-  }
-  // Draw the final leftover text
-  sprite.drawString(line + word, x, currentY);
+constexpr TempColorTable buildTempColors()
+{
+  TempColorTable t = {};
+  for (int i = 0; i < TEMP_LUT_SIZE; i++)
+    t.colors[i] = tempColorAt(TEMP_LUT_MIN + (double)i / TEMP_LUT_STEPS);
+  return t;
 }
 
-// Get color based on temperature: blue (cold) -> white (neutral) -> orange (hot)
+inline constexpr TempColorTable TEMP_COLORS = buildTempColors(); // In flash
+
+// Get color based on temperature - the table entry nearest temp
 inline uint16_t getTempColor(float temp)
 {
-  if (temp <= 15)
-  {
-    return TFT_BLUE;
-  }
-  else if (temp >= 40)
-  {
-    return COLOR_ACCENT;
-  }
-  else if (temp >= 24 && temp <= 26)
-  {
-    return COLOR_TEXT;
-  }
-  else if (temp < 24)
-  {
-    // Gradient from blue (15) to white (24)
-    float ratio = (temp - 15.0) / 9.0;
-    int r = ratio * 255;
-    int g = ratio * 255;
-    int b = 255;
-    return sprite.color565(r, g, b);
-  }
-  else
-  {
-    // Gradient from white (26) to orange (40)
-    float ratio = (temp - 26.0) / 14.0;
-    int r = 255;
-    int g = 255 - (ratio * 155);
-    int b = 255 - (ratio * 255);
-    return sprite.color565(r, g, b);
-  }
+  float pos = (temp - TEMP_LUT_MIN) * TEMP_LUT_STEPS + 0.5f;
+  if (!(pos > 0)) // Also NaN
+    return TEMP_COLORS.colors[0];
+  int i = (int)pos;
+  return TEMP_COLORS.colors[i < TEMP_LUT_SIZE ? i : TEMP_LUT_SIZE - 1];
+}
+
+// UV Index bands, by whole index: 0-2 low, 3-5 moderate, 6-7 high, 8-10
+// very high, 11+ extreme
+enum UVLevel
+{
+  UV_LOW,
+  UV_MODERATE,
+  UV_HIGH,
+  UV_VERY_HIGH,
+  UV_EXTREME
+};
+
+inline UVLevel getUVLevel(float uvi)
+{
+  static constexpr uint8_t LEVELS[12] = {UV_LOW, UV_LOW, UV_LOW, UV_MODERATE, UV_MODERATE, UV_MODERATE,
+                                         UV_HIGH, UV_HIGH, UV_VERY_HIGH, UV_VERY_HIGH, UV_VERY_HIGH, UV_EXTREME};
+  if (!(uvi >= 1)) // Also NaN
+    return UV_LOW;
+  int i = (int)uvi;
+  return (UVLevel)LEVELS[i < 12 ? i : 11];
 }
 
-// Get UV Index description
-inline String getUVDescription(float uvi)
+// Get UV Index description (points into a static table)
+inline const char *getUVDescription(float uvi)
 {
-  if (uvi < 3)
-    return "Low";
-  if (uvi < 6)
-    return "Moderate";
-  if (uvi < 8)
-    return "High";
-  if (uvi < 11)
-    return "Very High";
-  return "Extreme";
+  static const char *const NAMES[] = {"Low", "Moderate", "High", "Very High", "Extreme"};
+  return NAMES[getUVLevel(uvi)];
 }
 
 // Get UV Index color
 inline uint16_t getUVColor(float uvi)
 {
-  if (uvi < 3)
-    return COLOR_SUCCESS;
-  if (uvi < 6)
-    return COLOR_SUN;
-  if (uvi < 8)
-    return COLOR_ACCENT;
-  if (uvi < 11)
-    return TFT_RED;
-  return TFT_MAGENTA;
+  static constexpr uint16_t COLORS[] = {COLOR_SUCCESS, COLOR_SUN, COLOR_ACCENT, COLOR_ALERT, COLOR_EXTREME};
+  return COLORS[getUVLevel(uvi)];
 }
 
 // Get ordinal suffix for day number (1st, 2nd, 3rd, etc.)
@@ -0,0 +1,510 @@
+/*
+ * Reading History for Weather Display
+ *
+ * Past current-conditions readings in a fixed ring of small blocks. Each
+ * block opens with a full sample; the rest are varint-coded deltas (slot
+ * gap, then one zigzag delta per channel), which is usually one byte each,
+ * so the ring holds about four days at 5-minute resolution in 6 KB. Blocks
+ * are saved to NVS under one key each: a finished block is written once,
+ * the open one at most every SAVE_INTERVAL, and NVS spreads the writes
+ * across its pages.
+ *
+ * HistorySparkline folds samples into per-column averages as they arrive,
+ * so drawing it never decodes the history. The ring and its NVS writes
+ * belong to one task; TrendHandoff passes finished trend lines to the one
+ * that draws them.
+ */
+
+#ifndef HISTORY_RING_H
+#define HISTORY_RING_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <TFT_eSPI.h>
+#include <rom/crc.h>
+#include <time.h>
+#include <atomic>
+#include "types.h"
+
+// Recorded channels, as scaled integers
+enum HistoryChannel
+{
+  HIST_TEMPERATURE, // 0.1 degC
+  HIST_PRESSURE,    // hPa
+  HIST_HUMIDITY,    // %
+  HIST_WIND,        // 0.1 m/s
+  HIST_CHANNELS
+};
+
+struct HistorySample
+{
+  uint32_t slot; // Epoch / SLOT_SECONDS
+  int16_t value[HIST_CHANNELS];
+};
+
+#define HISTORY_BLOCK_BYTES 256
+
+struct HistoryBlock
+{
+  uint32_t magic;
+  uint32_t seq;       // Blocks since the history began; stored at seq % BLOCKS
+  uint32_t firstSlot; // Slot of the opening sample
+  int16_t first[HIST_CHANNELS];
+  uint16_t used;  // Delta bytes in data
+  uint16_t count; // Samples, including the opening one - 0 if the block is empty
+  uint32_t crc;   // CRC32 of the header above and the used bytes of data
+  uint8_t data[HISTORY_BLOCK_BYTES - 28];
+};
+static_assert(sizeof(HistoryBlock) == HISTORY_BLOCK_BYTES, "HistoryBlock must pack to its nominal size");
+
+class HistoryRing
+{
+public:
+  static const uint32_t MAGIC = 0x57484953; // "WHIS"
+  static const uint32_t SLOT_SECONDS = 300;
+  static const int BLOCKS = 24;
+  static const time_t SAVE_INTERVAL = 1800; // The open block goes to NVS at most this often
+
+  // Bumped on every append, so readers can tell when to look again
+  uint32_t revision = 0;
+
+  // Position in the history, for reading forward a sample at a time
+  struct Cursor
+  {
+    uint32_t seq = 0;    // Block being read
+    uint16_t index = 0;  // Samples of it already returned
+    uint16_t offset = 0; // Delta bytes of it already read
+    HistorySample last = {};
+    bool valid = false; // False once the block was overwritten - seek again
+  };
+
+  // Record a reading taken at epoch at. One sample per slot: false for a
+  // reading in the same slot as the newest (or older, if the clock went back).
+  bool append(time_t at, const WeatherData &d)
+  {
+    if (at <= 0)
+      return false;
+    HistorySample s;
+    s.slot = at / SLOT_SECONDS;
+    s.value[HIST_TEMPERATURE] = clamp16(lroundf(d.temperature * 10));
+    s.value[HIST_PRESSURE] = clamp16(d.pressure);
+    s.value[HIST_HUMIDITY] = clamp16(d.humidity);
+    s.value[HIST_WIND] = clamp16(lroundf(d.windSpeed * 10));
+
+    if (!empty && s.slot <= newestSample.slot)
+      return false;
+
+    HistoryBlock &open = block(headSeq);
+    uint8_t encoded[MAX_SAMPLE_BYTES];
+    int len = empty ? 0 : encode(s, newestSample, encoded);
+    if (empty || open.used + len > (int)sizeof(open.data) || open.count == UINT16_MAX)
+    {
+      if (!empty)
+      {
+        dirty |= 1u << slotOf(headSeq); // Seal it - saved on the next persist
+        headSeq++;
+      }
+      startBlock(block(headSeq), headSeq, s);
+      empty = false;
+    }
+    else
+    {
+      memcpy(open.data + open.used, encoded, len);
+      open.used += len;
+      open.count++;
+    }
+    dirty |= 1u << slotOf(headSeq);
+    newestSample = s;
+    revision++;
+    return true;
+  }
+
+  bool isEmpty() const { return empty; }
+  const HistorySample &newest() const { return newestSample; }
+
+  // Place c just before the first sample of the block holding fromSlot (or
+  // the oldest block), so reading forward passes fromSlot within one block
+  void seek(Cursor &c, uint32_t fromSlot) const
+  {
+    c = Cursor();
+    if (empty)
+      return;
+    uint32_t seq = oldestSeq();
+    while (seq < headSeq && block(seq + 1).firstSlot <= fromSlot)
+      seq++;
+    c.seq = seq;
+    c.valid = true;
+  }
+
+  // The sample after c, advancing c. False at the end of the history (c
+  // stays put, and reads on once more is appended) or if c was overwritten
+  // (c.valid turns false).
+  bool next(Cursor &c, HistorySample &out) const
+  {
+    while (c.valid)
+    {
+      const HistoryBlock &b = block(c.seq);
+      if (b.seq != c.seq || b.count == 0)
+      {
+        c.valid = false;
+        return false;
+      }
+      if (c.index == 0)
+      {
+        c.last.slot = b.firstSlot;
+        memcpy(c.last.value, b.first, sizeof(b.first));
+      }
+      else if (c.index < b.count)
+      {
+        c.offset += decode(b.data + c.offset, c.last);
+      }
+      else if (c.seq < headSeq)
+      {
+        c.seq++;
+        c.index = 0;
+        c.offset = 0;
+        continue;
+      }
+      else
+      {
+        return false;
+      }
+      c.index++;
+      out = c.last;
+      return true;
+    }
+    return false;
+  }
+
+  // Write sealed blocks, and the open one if SAVE_INTERVAL has passed
+  void persist(time_t now)
+  {
+    uint32_t openBit = empty ? 0 : 1u << slotOf(headSeq);
+    uint32_t toWrite = dirty & ~openBit;
+    if ((dirty & openBit) && (savedAt == 0 || now - savedAt >= SAVE_INTERVAL))
+      toWrite |= openBit;
+    if (toWrite == 0)
+      return;
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false))
+    {
+      Serial.println("History: NVS unavailable");
+      return;
+    }
+    for (int i = 0; i < BLOCKS; i++)
+    {
+      if (!(toWrite & (1u << i)))
+        continue;
+      HistoryBlock &b = blocks[i];
+      b.crc = checksum(b);
+      char key[8];
+      snprintf(key, sizeof(key), "b%02d", i);
+      if (prefs.putBytes(key, &b, sizeof(b)) == sizeof(b))
+        dirty &= ~(1u << i);
+      else
+        Serial.printf("History: NVS write of block %d failed\n", i);
+    }
+    prefs.end();
+    if (toWrite & openBit)
+      savedAt = now;
+  }
+
+  // Restore the saved blocks. Call once at boot, before any append.
+  void load()
+  {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true))
+      return;
+    bool found = false;
+    uint32_t newestSeq = 0;
+    for (int i = 0; i < BLOCKS; i++)
+    {
+      char key[8];
+      snprintf(key, sizeof(key), "b%02d", i);
+      HistoryBlock &b = blocks[i];
+      bool ok = prefs.getBytesLength(key) == sizeof(b) && prefs.getBytes(key, &b, sizeof(b)) == sizeof(b) &&
+                b.magic == MAGIC && b.count > 0 && slotOf(b.seq) == i && b.used <= sizeof(b.data) &&
+                b.crc == checksum(b);
+      if (!ok)
+      {
+        b = HistoryBlock();
+        continue;
+      }
+      if (!found || b.seq > newestSeq)
+        newestSeq = b.seq;
+      found = true;
+    }
+    prefs.end();
+    if (!found)
+      return;
+
+    // Drop blocks left over from before a gap in the sequence
+    for (int i = 0; i < BLOCKS; i++)
+    {
+      if (blocks[i].count > 0 && (blocks[i].seq > newestSeq || newestSeq - blocks[i].seq >= BLOCKS))
+        blocks[i] = HistoryBlock();
+    }
+    headSeq = newestSeq;
+    empty = false;
+    Cursor c;
+    c.seq = headSeq;
+    c.valid = true;
+    HistorySample s;
+    while (next(c, s))
+      newestSample = s;
+    revision++;
+    Serial.printf("History: restored %lu blocks, newest %lu s old\n", (unsigned long)(headSeq - oldestSeq() + 1),
+                  (unsigned long)(time(NULL) - (time_t)newestSample.slot * SLOT_SECONDS));
+  }
+
+private:
+  // Slot gap, then a zigzag delta per channel - up to 5 bytes each
+  static const int MAX_SAMPLE_BYTES = 5 * (1 + HIST_CHANNELS);
+  static constexpr const char *NVS_NAMESPACE = "history";
+
+  HistoryBlock blocks[BLOCKS] = {};
+  uint32_t headSeq = 0; // Block being appended to
+  bool empty = true;
+  HistorySample newestSample = {};
+  uint32_t dirty = 0; // Bit per block index not yet in NVS
+  time_t savedAt = 0;
+  static_assert(BLOCKS <= 32, "Dirty mask holds 32 blocks");
+
+  static int slotOf(uint32_t seq) { return seq % BLOCKS; }
+  HistoryBlock &block(uint32_t seq) { return blocks[slotOf(seq)]; }
+  const HistoryBlock &block(uint32_t seq) const { return blocks[slotOf(seq)]; }
+
+  uint32_t oldestSeq() const
+  {
+    uint32_t seq = headSeq;
+    while (headSeq - seq < BLOCKS - 1 && seq > 0 && block(seq - 1).count > 0 && block(seq - 1).seq == seq - 1)
+      seq--;
+    return seq;
+  }
+
+  static void startBlock(HistoryBlock &b, uint32_t seq, const HistorySample &s)
+  {
+    b = HistoryBlock();
+    b.magic = MAGIC;
+    b.seq = seq;
+    b.firstSlot = s.slot;
+    memcpy(b.first, s.value, sizeof(b.first));
+    b.count = 1;
+  }
+
+  static int16_t clamp16(long v) { return (int16_t)max((long)INT16_MIN, min(v, (long)INT16_MAX)); }
+
+  static int putVarint(uint8_t *p, uint32_t v)
+  {
+    int n = 0;
+    while (v >= 0x80)
+    {
+      p[n++] = (v & 0x7F) | 0x80;
+      v >>= 7;
+    }
+    p[n++] = v;
+    return n;
+  }
+
+  static int getVarint(const uint8_t *p, uint32_t &v)
+  {
+    v = 0;
+    int n = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+      uint8_t b = p[n++];
+      v |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80))
+        break;
+    }
+    return n;
+  }
+
+  static uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+  static int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+  static int encode(const HistorySample &s, const HistorySample &prev, uint8_t *out)
+  {
+    int n = putVarint(out, s.slot - prev.slot);
+    for (int c = 0; c < HIST_CHANNELS; c++)
+      n += putVarint(out + n, zigzag((int32_t)s.value[c] - prev.value[c]));
+    return n;
+  }
+
+  // Apply the deltas at p to s; returns the bytes read
+  static int decode(const uint8_t *p, HistorySample &s)
+  {
+    uint32_t v;
+    int n = getVarint(p, v);
+    s.slot += v;
+    for (int c = 0; c < HIST_CHANNELS; c++)
+    {
+      n += getVarint(p + n, v);
+      s.value[c] += unzigzag(v);
+    }
+    return n;
+  }
+
+  static uint32_t checksum(const HistoryBlock &b)
+  {
+    uint32_t crc = crc32_le(0, (const uint8_t *)&b, offsetof(HistoryBlock, crc));
+    return crc32_le(crc, b.data, b.used);
+  }
+};
+
+// Trend line of one channel over the last COLUMNS columns of history
+class HistorySparkline
+{
+public:
+  static const int COLUMNS = 48;
+
+  // slotsPerColumn history slots averaged into each column; the vertical
+  // scale never shrinks below minSpan (channel units), so a steady reading
+  // draws flat instead of magnifying noise
+  HistorySparkline(HistoryChannel channel, uint32_t slotsPerColumn, int minSpan)
+      : channel(channel), slotsPerColumn(slotsPerColumn), minSpan(minSpan) {}
+
+  // Fold in whatever was appended since the last call
+  void update(const HistoryRing &ring)
+  {
+    if (ring.revision == seenRevision)
+      return;
+    seenRevision = ring.revision;
+    if (ring.isEmpty())
+      return;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+      if (!cursor.valid)
+        restart(ring);
+      HistorySample s;
+      while (ring.next(cursor, s))
+        add(s);
+      if (cursor.valid)
+        return;
+    }
+  }
+
+  // Line across w x h at (x, y), newest column at the right edge, with a
+  // dot on the newest value
+  void draw(TFT_eSprite &dst, int x, int y, int w, int h, uint16_t color, uint16_t dotColor) const
+  {
+    int lo = INT16_MAX;
+    int hi = INT16_MIN;
+    for (int i = 0; i < COLUMNS; i++)
+    {
+      const Column &col = columns[i];
+      if (col.samples == 0 || col.id + COLUMNS <= newestColumn)
+        continue;
+      int v = average(col);
+      lo = min(lo, v);
+      hi = max(hi, v);
+    }
+    if (lo > hi)
+      return;
+    if (hi - lo < minSpan)
+    {
+      int pad = (minSpan - (hi - lo)) / 2;
+      lo -= pad;
+      hi = lo + minSpan;
+    }
+
+    int prevX = -1;
+    int prevY = 0;
+    for (int i = 0; i < COLUMNS; i++)
+    {
+      uint32_t id = newestColumn - (COLUMNS - 1) + i;
+      const Column &col = columns[id % COLUMNS];
+      if (col.samples == 0 || col.id != id)
+        continue;
+      int px = x + i * (w - 1) / (COLUMNS - 1);
+      int py = y + h - 1 - (average(col) - lo) * (h - 1) / (hi - lo);
+      if (prevX >= 0)
+        dst.drawLine(prevX, prevY, px, py, color);
+      prevX = px;
+      prevY = py;
+    }
+    if (prevX >= 0)
+      dst.fillCircle(prevX, prevY, 2, dotColor);
+  }
+
+private:
+  struct Column
+  {
+    uint32_t id = 0; // Slot / slotsPerColumn
+    int32_t sum = 0;
+    uint16_t samples = 0;
+  };
+
+  HistoryChannel channel;
+  uint32_t slotsPerColumn;
+  int minSpan;
+  HistoryRing::Cursor cursor;
+  uint32_t seenRevision = 0;
+  uint32_t newestColumn = 0;
+  Column columns[COLUMNS]; // Indexed by id % COLUMNS
+
+  static int average(const Column &col) { return (col.sum + (int32_t)col.samples / 2) / col.samples; }
+
+  // Start over from the window ending at the newest sample
+  void restart(const HistoryRing &ring)
+  {
+    for (auto &col : columns)
+      col = Column();
+    newestColumn = ring.newest().slot / slotsPerColumn;
+    uint32_t windowSlots = COLUMNS * slotsPerColumn;
+    uint32_t newestSlot = ring.newest().slot;
+    ring.seek(cursor, newestSlot > windowSlots ? newestSlot - windowSlots : 0);
+  }
+
+  void add(const HistorySample &s)
+  {
+    uint32_t id = s.slot / slotsPerColumn;
+    if (id + COLUMNS <= newestColumn)
+      return; // Before the window
+    newestColumn = max(newestColumn, id);
+    Column &col = columns[id % COLUMNS];
+    if (col.id != id)
+      col = Column();
+    col.id = id;
+    col.sum += s.value[channel];
+    col.samples++;
+  }
+};
+
+// A trend line handed from the task that keeps the history to the render
+// loop, as forecasts are (LocationWeather): the writer fills the copy the
+// loop isn't drawing and publishes its index; the loop takes it on its next
+// draw.
+class TrendHandoff
+{
+public:
+  explicit TrendHandoff(const HistorySparkline &blank) : buffers{blank, blank} {}
+
+  // Writer side
+  void publish(const HistorySparkline &line)
+  {
+    int revoked = pending.exchange(-1); // Not taken yet - reuse it
+    int back = revoked >= 0 ? revoked : 1 - published;
+    buffers[back] = line;
+    published = back;
+    pending.store(back);
+  }
+
+  // Render side: the newest published line
+  const HistorySparkline &take()
+  {
+    int newest = pending.exchange(-1);
+    if (newest >= 0)
+      shown = newest;
+    return buffers[shown];
+  }
+
+private:
+  HistorySparkline buffers[2];
+  std::atomic<int> pending{-1};
+  int published = 0; // Owned by the writer
+  int shown = 0;     // Owned by the render loop
+};
+
+#endif // HISTORY_RING_H
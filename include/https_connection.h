@@ -0,0 +1,407 @@
+/*
+ * Persistent HTTPS Connection for Weather Display
+ *
+ * A long-lived WiFiClientSecure that issues HTTP/1.1 keep-alive GETs, so
+ * back-to-back requests skip DNS, TCP and the TLS handshake. DNS results
+ * are cached, the root CA can be pinned, and each request records a
+ * phase breakdown (DNS / connect + TLS / first byte / body). The same
+ * code over a plain WiFiClient is HttpConnection, for the LAN relay.
+ */
+
+#ifndef HTTPS_CONNECTION_H
+#define HTTPS_CONNECTION_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+
+// Timing of one request, in milliseconds
+struct FetchPhases
+{
+  uint32_t dnsMs;
+  uint32_t connectMs; // TCP connect, plus the TLS handshake over HTTPS (one call in WiFiClientSecure)
+  uint32_t firstByteMs;
+  uint32_t bodyMs;
+  bool dnsCached;
+  bool reused; // Request went over an already-open connection
+};
+
+// Response body reader - enforces Content-Length or decodes chunked encoding,
+// so the connection can be drained and reused afterwards
+class HttpBodyStream : public Stream
+{
+public:
+  void begin(Client *source, long contentLength, bool chunked, unsigned long timeoutMs)
+  {
+    client = source;
+    remaining = contentLength;
+    isChunked = chunked;
+    chunkLeft = 0;
+    finished = (!chunked && contentLength == 0);
+    peeked = -1;
+    timeout = timeoutMs;
+  }
+
+  int available() override
+  {
+    if (finished)
+      return 0;
+    return peeked >= 0 ? 1 : client->available();
+  }
+
+  int read() override
+  {
+    if (peeked >= 0)
+    {
+      int c = peeked;
+      peeked = -1;
+      return c;
+    }
+    return nextByte();
+  }
+
+  int peek() override
+  {
+    if (peeked < 0)
+      peeked = nextByte();
+    return peeked;
+  }
+
+  size_t write(uint8_t) override { return 0; }
+
+  // Consume whatever the parser left unread. False if the body was cut short.
+  bool drain()
+  {
+    peeked = -1;
+    while (!finished)
+    {
+      if (nextByte() < 0 && !finished)
+        return false;
+    }
+    return true;
+  }
+
+  bool complete() const { return finished; }
+
+private:
+  Client *client = nullptr;
+  long remaining = -1; // -1 = read until the server closes
+  bool isChunked = false;
+  long chunkLeft = 0;
+  bool finished = true;
+  int peeked = -1;
+  unsigned long timeout = 10000;
+
+  int rawByte()
+  {
+    unsigned long start = millis();
+    while (millis() - start < timeout)
+    {
+      int c = client->read();
+      if (c >= 0)
+        return c;
+      if (!client->connected())
+        return -1;
+      delay(1);
+    }
+    return -1;
+  }
+
+  // Read a chunk-size line ("1a2f;ext\r\n"), -1 on error
+  long readChunkSize()
+  {
+    long size = 0;
+    bool digits = false;
+    bool inExtension = false;
+    for (;;)
+    {
+      int c = rawByte();
+      if (c < 0)
+        return -1;
+      if (c == '\n')
+        return digits ? size : -1;
+      if (c == '\r' || inExtension)
+        continue;
+      if (c == ';')
+      {
+        inExtension = true;
+        continue;
+      }
+      int v = isdigit(c) ? c - '0' : (isxdigit(c) ? (tolower(c) - 'a' + 10) : -1);
+      if (v < 0)
+        return -1;
+      size = size * 16 + v;
+      digits = true;
+    }
+  }
+
+  int nextByte()
+  {
+    if (finished)
+      return -1;
+
+    if (!isChunked)
+    {
+      int c = rawByte();
+      if (c < 0)
+      {
+        // A server close ends a body with no Content-Length
+        if (remaining < 0)
+          finished = true;
+        return -1;
+      }
+      if (remaining > 0 && --remaining == 0)
+        finished = true;
+      return c;
+    }
+
+    if (chunkLeft == 0)
+    {
+      chunkLeft = readChunkSize();
+      if (chunkLeft <= 0)
+      {
+        // Last chunk: skip the CRLF that ends the (empty) trailer
+        if (chunkLeft == 0)
+        {
+          rawByte();
+          rawByte();
+        }
+        finished = true;
+        return -1;
+      }
+    }
+
+    int c = rawByte();
+    if (c < 0)
+      return -1;
+    if (--chunkLeft == 0)
+    {
+      // CRLF after each chunk's data
+      rawByte();
+      rawByte();
+    }
+    return c;
+  }
+};
+
+// What differs between the TLS and plain transports
+inline void configureClient(WiFiClientSecure &client, const char *rootCA, unsigned long timeoutMs)
+{
+  if (rootCA != nullptr)
+    client.setCACert(rootCA);
+  else
+    client.setInsecure();
+  client.setHandshakeTimeout(timeoutMs / 1000);
+}
+
+inline void configureClient(WiFiClient &, const char *, unsigned long) {}
+
+inline bool openClient(WiFiClientSecure &client, IPAddress ip, uint16_t port, const char *host, const char *rootCA)
+{
+  return client.connect(ip, port, host, rootCA, nullptr, nullptr);
+}
+
+inline bool openClient(WiFiClient &client, IPAddress ip, uint16_t port, const char *, const char *)
+{
+  return client.connect(ip, port);
+}
+
+template <typename ClientT>
+class KeepAliveConnection
+{
+public:
+  static const unsigned long TIMEOUT_MS = 10000;
+  static const unsigned long DNS_TTL_MS = 3600000; // Re-resolve hourly
+
+  KeepAliveConnection(const char *host, uint16_t port) : host(host), port(port) {}
+
+  // Pin a root CA (PEM). Without one the server certificate is not verified.
+  // Plain HTTP ignores it.
+  void begin(const char *rootCA)
+  {
+    this->rootCA = rootCA;
+    configureClient(client, rootCA, TIMEOUT_MS);
+  }
+
+  // Send a GET for path and read the response headers. Returns the HTTP status
+  // (or a negative value on connection failure); the body is then in body().
+  int get(const char *path)
+  {
+    phases = FetchPhases{};
+    int status = attempt(path);
+    if (status <= 0 && phases.reused)
+    {
+      // The server timed out our idle connection - retry once on a fresh one
+      client.stop();
+      phases = FetchPhases{};
+      status = attempt(path);
+    }
+    return status;
+  }
+
+  Stream &body() { return bodyStream; }
+
+  // Finish the request - drains the body so the connection can be reused,
+  // or closes it if the server asked to or the body was cut short
+  void finish()
+  {
+    if (!bodyStream.drain() || !keepAlive)
+      client.stop();
+    phases.bodyMs = millis() - bodyStart;
+  }
+
+  void close() { client.stop(); }
+
+  const FetchPhases &lastPhases() const { return phases; }
+
+private:
+  const char *host;
+  uint16_t port;
+  const char *rootCA = nullptr;
+  ClientT client;
+  HttpBodyStream bodyStream;
+  FetchPhases phases = {};
+  bool keepAlive = false;
+  unsigned long bodyStart = 0;
+
+  IPAddress cachedIp;
+  bool haveIp = false;
+  unsigned long resolvedAt = 0;
+
+  bool resolve()
+  {
+    unsigned long start = millis();
+    if (haveIp && millis() - resolvedAt < DNS_TTL_MS)
+    {
+      phases.dnsCached = true;
+      return true;
+    }
+    haveIp = WiFi.hostByName(host, cachedIp) == 1;
+    resolvedAt = millis();
+    phases.dnsMs = millis() - start;
+    return haveIp;
+  }
+
+  int attempt(const char *path)
+  {
+    keepAlive = false;
+    bodyStart = millis();
+    phases.reused = client.connected();
+    if (!phases.reused)
+    {
+      if (!resolve())
+        return -1;
+      unsigned long start = millis();
+      if (!openClient(client, cachedIp, port, host, rootCA))
+      {
+        haveIp = false; // The address may have moved - resolve again next time
+        return -2;
+      }
+      phases.connectMs = millis() - start;
+    }
+
+    // One write, so the request goes out as a single TLS record (or segment)
+    char request[512];
+    int len = snprintf(request, sizeof(request),
+                       "GET %s HTTP/1.1\r\n"
+                       "Host: %s\r\n"
+                       "User-Agent: WeatherReporter\r\n"
+                       "Accept-Encoding: identity\r\n"
+                       "Connection: keep-alive\r\n\r\n",
+                       path, host);
+    if (len <= 0 || len >= (int)sizeof(request))
+      return -3;
+
+    unsigned long sent = millis();
+    if (client.write((const uint8_t *)request, len) != (size_t)len)
+      return -4;
+
+    return readHeaders(sent);
+  }
+
+  // Read one header line into buf (CRLF stripped), false on timeout
+  bool readLine(char *buf, size_t size)
+  {
+    size_t n = 0;
+    unsigned long start = millis();
+    while (millis() - start < TIMEOUT_MS)
+    {
+      int c = client.read();
+      if (c < 0)
+      {
+        if (!client.connected())
+          return false;
+        delay(1);
+        continue;
+      }
+      if (c == '\n')
+      {
+        if (n > 0 && buf[n - 1] == '\r')
+          n--;
+        buf[n] = '\0';
+        return true;
+      }
+      if (n < size - 1)
+        buf[n++] = c;
+    }
+    return false;
+  }
+
+  int readHeaders(unsigned long sent)
+  {
+    char line[256];
+    if (!readLine(line, sizeof(line)))
+      return -5;
+    phases.firstByteMs = millis() - sent;
+    bodyStart = millis();
+
+    // "HTTP/1.1 200 OK"
+    int status = 0;
+    bool http11 = strncmp(line, "HTTP/1.1", 8) == 0;
+    const char *space = strchr(line, ' ');
+    if (space != nullptr)
+      status = atoi(space + 1);
+
+    long contentLength = -1;
+    bool chunked = false;
+    keepAlive = http11;
+    for (;;)
+    {
+      if (!readLine(line, sizeof(line)))
+        return -5;
+      if (line[0] == '\0')
+        break;
+      if (strncasecmp(line, "Content-Length:", 15) == 0)
+        contentLength = atol(line + 15);
+      else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0 && strstr(line + 18, "chunked") != nullptr)
+        chunked = true;
+      else if (strncasecmp(line, "Connection:", 11) == 0)
+        keepAlive = strstr(line + 11, "close") == nullptr && strstr(line + 11, "Close") == nullptr;
+    }
+
+    // Without a length or chunking the body ends when the server closes
+    if (!chunked && contentLength < 0)
+      keepAlive = false;
+
+    bodyStream.begin(&client, contentLength, chunked, TIMEOUT_MS);
+    bodyStream.setTimeout(TIMEOUT_MS);
+    return status;
+  }
+};
+
+// OpenWeatherMap over TLS
+class HttpsConnection : public KeepAliveConnection<WiFiClientSecure>
+{
+public:
+  HttpsConnection(const char *host, uint16_t port = 443) : KeepAliveConnection(host, port) {}
+};
+
+// A relay on the LAN over plain HTTP - no TLS code is linked in unless
+// an HttpsConnection is also used
+class HttpConnection : public KeepAliveConnection<WiFiClient>
+{
+public:
+  HttpConnection(const char *host, uint16_t port = 80) : KeepAliveConnection(host, port) {}
+};
+
+#endif // HTTPS_CONNECTION_H
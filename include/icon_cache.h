@@ -0,0 +1,310 @@
+/*
+ * Weather Icon Cache for Weather Display
+ *
+ * Rasterizes each distinct (icon class, size, night) combination once
+ * into a small 8-bit sprite (4-bit for a palettized frame) and blits it
+ * into the frame afterwards.
+ * Tiles live within a fixed byte budget and are evicted least recently
+ * used first.
+ */
+
+#ifndef ICON_CACHE_H
+#define ICON_CACHE_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "palette.h"
+
+// Icon classes - every OWM code in a class renders identically
+enum IconClass
+{
+  ICON_CLEAR,
+  ICON_FEW_CLOUDS,
+  ICON_CLOUDY,
+  ICON_OVERCAST,
+  ICON_RAIN,
+  ICON_STORM,
+  ICON_SNOW,
+  ICON_MIST,
+  ICON_DEFAULT
+};
+
+// Map an OWM condition code to its icon class (mirrors renderWeatherIcon)
+inline IconClass iconClassFor(int code)
+{
+  if (code == 800)
+    return ICON_CLEAR;
+  if (code == 801)
+    return ICON_FEW_CLOUDS;
+  if (code >= 802 && code <= 803)
+    return ICON_CLOUDY;
+  if (code == 804)
+    return ICON_OVERCAST;
+  if (code >= 500 && code <= 531)
+    return ICON_RAIN;
+  if (code >= 200 && code <= 232)
+    return ICON_STORM;
+  if (code >= 600 && code <= 622)
+    return ICON_SNOW;
+  if (code >= 701 && code <= 781)
+    return ICON_MIST;
+  return ICON_DEFAULT;
+}
+
+// Only the clear and few-clouds icons have a night variant
+inline bool iconNight(IconClass cls, bool isNight)
+{
+  return isNight && (cls == ICON_CLEAR || cls == ICON_FEW_CLOUDS);
+}
+
+// Half-extent of an icon tile - covers the mist lines, which extend a fixed
+// 16 px below the icon centre regardless of size
+inline int iconTileHalf(int size)
+{
+  int r = size / 2;
+  return max(r, (int)(r * 0.3) + 16) + 2;
+}
+
+// Renders an icon centred on (x, y) into dst
+typedef void (*IconRenderer)(TFT_eSprite &dst, int code, int x, int y, int size, bool isNight);
+
+class IconCache
+{
+public:
+  static const uint32_t BUDGET_BYTES = 24 * 1024;
+  static const int MAX_ENTRIES = 16;
+  static const uint16_t KEY_COLOR = COLOR_EXTREME; // Transparent background, never used by icons
+
+  // Counters for reading cache effectiveness
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t evictions = 0;
+  uint32_t bytesUsed = 0;
+
+  IconCache(TFT_eSPI *tft, IconRenderer render) : tft(tft), render(render) {}
+
+  // Draw an icon centred on (x, y), rendering it into the cache on a miss
+  void draw(TFT_eSprite &dst, int code, int x, int y, int size, bool isNight)
+  {
+    IconClass cls = iconClassFor(code);
+    isNight = iconNight(cls, isNight);
+
+    int depth = dst.getColorDepth();
+    if (depth != 4 && depth != 8 && depth != 16)
+    {
+      render(dst, code, x, y, size, isNight);
+      return;
+    }
+
+    // Palettized frames take 4-bit tiles holding palette slots
+    int tileDepth = depth == 4 ? 4 : 8;
+    Entry *entry = find(cls, size, isNight, tileDepth);
+    if (entry != nullptr)
+    {
+      hits++;
+    }
+    else
+    {
+      misses++;
+      entry = insert(cls, code, size, isNight, tileDepth);
+      if (entry == nullptr)
+      {
+        // Over budget or out of memory - draw directly
+        render(dst, code, x, y, size, isNight);
+        return;
+      }
+    }
+
+    entry->lastUse = ++tick;
+    blit(dst, *entry, x, y);
+  }
+
+private:
+  struct Entry
+  {
+    TFT_eSprite *tile = nullptr;
+    bool used = false;
+    IconClass cls = ICON_DEFAULT;
+    int16_t size = 0;
+    bool isNight = false;
+    int8_t depth = 8;
+    int16_t half = 0; // Tile is (2 * half) pixels square, centred on the icon
+    uint32_t lastUse = 0;
+  };
+
+  TFT_eSPI *tft;
+  IconRenderer render;
+  Entry entries[MAX_ENTRIES];
+  uint32_t tick = 0;
+
+  static uint32_t tileBytes(int half, int depth)
+  {
+    return (uint32_t)(2 * half) * (2 * half) * depth / 8;
+  }
+
+  Entry *find(IconClass cls, int size, bool isNight, int depth)
+  {
+    for (int i = 0; i < MAX_ENTRIES; i++)
+    {
+      Entry &e = entries[i];
+      if (e.used && e.cls == cls && e.size == size && e.isNight == isNight && e.depth == depth)
+        return &e;
+    }
+    return nullptr;
+  }
+
+  Entry *insert(IconClass cls, int code, int size, bool isNight, int depth)
+  {
+    int half = iconTileHalf(size);
+    uint32_t bytes = tileBytes(half, depth);
+    if (bytes > BUDGET_BYTES)
+      return nullptr;
+
+    // Evict least recently used tiles until the new one fits
+    Entry *slot = freeSlot();
+    while (slot == nullptr || bytesUsed + bytes > BUDGET_BYTES)
+    {
+      Entry *victim = leastRecent();
+      if (victim == nullptr)
+        return nullptr;
+      release(*victim);
+      evictions++;
+      if (slot == nullptr)
+        slot = victim;
+    }
+
+    if (slot->tile == nullptr)
+      slot->tile = new TFT_eSprite(tft);
+    slot->tile->setColorDepth(depth);
+    if (slot->tile->createSprite(2 * half, 2 * half) == nullptr)
+      return nullptr;
+
+    slot->tile->fillSprite(KEY_COLOR);
+    render(*slot->tile, code, half, half, size, isNight);
+
+    slot->used = true;
+    slot->cls = cls;
+    slot->size = size;
+    slot->isNight = isNight;
+    slot->depth = depth;
+    slot->half = half;
+    bytesUsed += bytes;
+    return slot;
+  }
+
+  Entry *freeSlot()
+  {
+    for (int i = 0; i < MAX_ENTRIES; i++)
+    {
+      if (!entries[i].used)
+        return &entries[i];
+    }
+    return nullptr;
+  }
+
+  Entry *leastRecent()
+  {
+    Entry *oldest = nullptr;
+    for (int i = 0; i < MAX_ENTRIES; i++)
+    {
+      Entry &e = entries[i];
+      if (e.used && (oldest == nullptr || e.lastUse < oldest->lastUse))
+        oldest = &e;
+    }
+    return oldest;
+  }
+
+  void release(Entry &e)
+  {
+    if (!e.used)
+      return;
+    e.tile->deleteSprite();
+    bytesUsed -= tileBytes(e.half, e.depth);
+    e.used = false;
+  }
+
+  // Copy non-key pixels of a tile into a 4, 8 or 16-bit sprite. Positions follow
+  // the sprite's viewport datum, so banded frames (a band-tall sprite with a
+  // shifted viewport) blit like full ones. With a viewport, width()/height()
+  // report its size, so it must span the sprite's full width and end at its
+  // last row - renderFrame()'s band viewports do.
+  void blit(TFT_eSprite &dst, const Entry &e, int x, int y)
+  {
+    const uint8_t *src = (const uint8_t *)e.tile->getPointer();
+    void *frame = dst.getPointer();
+    if (src == nullptr || frame == nullptr)
+      return;
+
+    bool wide = dst.getColorDepth() == 16;
+    if (wide && !lutReady)
+      buildLut();
+
+    bool packed = e.depth == 4;
+    uint8_t key = packed ? KEY_COLOR & 0x0F : tft->color16to8(KEY_COLOR);
+    int dim = 2 * e.half;
+    int left = x - e.half + dst.getViewportX();
+    int top = y - e.half + dst.getViewportY();
+    int frameW = dst.width();
+    int frameH = dst.height() + dst.getViewportY();
+    int colStart = max(0, -left);
+    int colEnd = min(dim, frameW - left);
+
+    for (int row = 0; row < dim; row++)
+    {
+      int fy = top + row;
+      if (fy < 0 || fy >= frameH)
+        continue;
+      if (packed)
+      {
+        // Two pixels per byte, left pixel in the high nibble
+        const uint8_t *s = src + row * dim / 2;
+        uint8_t *d = (uint8_t *)frame + fy * frameW / 2;
+        for (int col = colStart; col < colEnd; col++)
+        {
+          uint8_t c = (col & 1) ? s[col >> 1] & 0x0F : s[col >> 1] >> 4;
+          if (c == key)
+            continue;
+          int fx = left + col;
+          uint8_t &pair = d[fx >> 1];
+          pair = (fx & 1) ? (pair & 0xF0) | c : (pair & 0x0F) | (c << 4);
+        }
+        continue;
+      }
+      const uint8_t *s = src + row * dim;
+      if (wide)
+      {
+        uint16_t *d = (uint16_t *)frame + fy * frameW + left;
+        for (int col = colStart; col < colEnd; col++)
+        {
+          if (s[col] != key)
+            d[col] = lut[s[col]];
+        }
+      }
+      else
+      {
+        uint8_t *d = (uint8_t *)frame + fy * frameW + left;
+        for (int col = colStart; col < colEnd; col++)
+        {
+          if (s[col] != key)
+            d[col] = s[col];
+        }
+      }
+    }
+  }
+
+  // RGB332 tile pixels -> RGB565 in the byte order 16-bit sprites store
+  uint16_t lut[256];
+  bool lutReady = false;
+
+  void buildLut()
+  {
+    for (int c = 0; c < 256; c++)
+    {
+      uint16_t color = tft->color8to16(c);
+      lut[c] = (color >> 8) | (color << 8);
+    }
+    lutReady = true;
+  }
+};
+
+#endif // ICON_CACHE_H
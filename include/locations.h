@@ -0,0 +1,149 @@
+/*
+ * Location Rotation for Weather Display
+ *
+ * The table of places the unit cycles through, each location's own
+ * double-buffered forecast, and the fetch rotation that spreads One Call
+ * requests across locations so the day's calls stay inside the OWM quota.
+ */
+
+#ifndef LOCATIONS_H
+#define LOCATIONS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <time.h>
+#include "types.h"
+
+struct Location
+{
+  const char *name; // Shown in the header
+  const char *latitude;
+  const char *longitude;
+};
+
+// One location's forecast. The fetch task fills the buffer the render
+// loop isn't reading and publishes its index; the render loop takes it on
+// its next pass, so switching to a location never waits for a fetch.
+struct LocationWeather
+{
+  WeatherData buffers[2];
+  std::atomic<int> pending{-1}; // Buffer published by the fetch task, -1 if none
+  int published = 0;            // Buffer the fetch task last published (owned by task)
+  int shown = 0;                // Buffer the render loop reads (owned by loop)
+  std::atomic<uint32_t> writes{0}; // Bumped when a buffer is claimed and again when it's released -
+                                   // odd while one is being written, so other readers can spot a torn copy
+
+  // Fetch side writes these before publishing
+  bool lastFetchOk = false;
+  time_t lastGoodFetch = 0; // Epoch of the newest good data
+
+  // Render side copies them when it takes a buffer
+  bool stale = false;
+  time_t staleSince = 0;
+};
+
+class FetchRotation
+{
+public:
+  static const uint32_t DAY_MS = 86400000UL;
+  static const int MAX_LOCATIONS = 16;
+
+  // Counters since boot
+  uint32_t callsToday = 0;
+  uint32_t quotaSkips = 0; // Fetches dropped because the day's budget was spent
+
+  // count locations, dailyQuota calls per UTC day (a tenth is held back for
+  // retries and manual use), each location no more often than minIntervalMs
+  FetchRotation(int count, uint32_t dailyQuota, unsigned long minIntervalMs)
+      : count(count), budget(dailyQuota - dailyQuota / 10), minIntervalMs(minIntervalMs)
+  {
+  }
+
+  // Time between two fetches - one per tick, locations in turn
+  unsigned long spacingMs() const
+  {
+    unsigned long perLocation = minIntervalMs / count;
+    unsigned long quotaFloor = (DAY_MS + budget - 1) / budget;
+    return max(perLocation, quotaFloor);
+  }
+
+  // How often each location is refreshed
+  unsigned long cycleMs() const { return spacingMs() * count; }
+
+  // Location to fetch next, or -1 when the day's budget is spent. Locations
+  // that have never been fetched go first, the rest in turn.
+  int next(time_t now)
+  {
+    long day = now / 86400; // OWM counts calls per UTC day
+    if (day != countedDay)
+    {
+      countedDay = day;
+      callsToday = 0;
+    }
+    if (callsToday >= budget)
+    {
+      quotaSkips++;
+      return -1;
+    }
+
+    int pick = -1;
+    for (int i = 0; i < count; i++)
+    {
+      if (!fetched[i])
+      {
+        pick = i;
+        break;
+      }
+    }
+    if (pick < 0)
+    {
+      pick = cursor;
+      cursor = (cursor + 1) % count;
+    }
+    fetched[pick] = true;
+    callsToday++;
+    return pick;
+  }
+
+  // Give back the call next() counted, for a fetch that wasn't made after all
+  void refund()
+  {
+    if (callsToday > 0)
+      callsToday--;
+  }
+
+  // Treat a location as fetched without spending a call (fresh cache at boot)
+  void markFetched(int index)
+  {
+    fetched[index] = true;
+  }
+
+  // Whether some location still has no fetch at all (boot fill)
+  bool hasUnfetched() const
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (!fetched[i])
+        return true;
+    }
+    return false;
+  }
+
+  uint32_t dailyBudget() const { return budget; }
+
+  void report()
+  {
+    Serial.printf("Fetch rotation: %lu of %lu calls today, %lu skipped over budget\n", (unsigned long)callsToday,
+                  (unsigned long)budget, (unsigned long)quotaSkips);
+  }
+
+private:
+  int count;
+  uint32_t budget;
+  unsigned long minIntervalMs;
+  int cursor = 0;
+  long countedDay = -1;
+  bool fetched[MAX_LOCATIONS] = {};
+};
+
+#endif // LOCATIONS_H
@@ -0,0 +1,473 @@
+/*
+ * Metrics Endpoint for Weather Display
+ *
+ * A small HTTP server for fleet monitoring, on the ESP-IDF httpd task
+ * (core 0, so it never competes with rendering on core 1):
+ *
+ *   /metrics       Prometheus text - fetch latency histogram, parse and
+ *                  frame times, input-to-photon percentiles, heap, WiFi
+ *                  RSSI and reconnects
+ *   /weather.bin   The raw WeatherData of the shown location, sent straight
+ *                  from its published buffer (layout per firmware build;
+ *                  windDir and dayName are device addresses, not text)
+ *   /weather.json  The same snapshot as JSON
+ *   PUT /assets    With ASSET_PACK and an ASSET_UPLOAD_TOKEN in
+ *                  credentials.h, install a new icon asset pack (see
+ *                  asset_store.h): curl -T assets.bin -H "Authorization:
+ *                  Bearer <token>" http://<display>/assets
+ *
+ * One client at a time, a fixed task stack and a fixed response buffer;
+ * everything is streamed in chunks, so a scraper costs no heap.
+ */
+
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include <stdarg.h>
+#include "perf_stats.h"
+#include "wifi_link.h"
+#include "locations.h"
+#include "weather_cache.h"
+#ifdef ASSET_PACK
+#include "asset_store.h"
+#endif
+
+// Fixed-size buffer flushed to the response as HTTP chunks
+class ChunkWriter
+{
+public:
+  explicit ChunkWriter(httpd_req_t *req) : req(req) {}
+
+  void printf(const char *fmt, ...)
+  {
+    for (int attempt = 0; attempt < 2 && ok; attempt++)
+    {
+      va_list args;
+      va_start(args, fmt);
+      int n = vsnprintf(buf + len, sizeof(buf) - len, fmt, args);
+      va_end(args);
+      if (n >= 0 && len + n < sizeof(buf))
+      {
+        len += n;
+        return;
+      }
+      flush(); // Didn't fit - send what's there and try again in an empty buffer
+    }
+  }
+
+  bool flush()
+  {
+    if (ok && len > 0)
+      ok = httpd_resp_send_chunk(req, buf, len) == ESP_OK;
+    len = 0;
+    return ok;
+  }
+
+  // Flush and end the chunked body
+  bool finish()
+  {
+    return flush() && httpd_resp_send_chunk(req, nullptr, 0) == ESP_OK;
+  }
+
+  bool ok = true;
+
+private:
+  httpd_req_t *req;
+  char buf[512];
+  size_t len = 0;
+};
+
+class MetricsServer
+{
+public:
+  static const uint16_t PORT = 80;
+  static const uint32_t STACK_SIZE = 6144; // vsnprintf of floats is the deepest call
+  static const int BIN_CHUNK = 1024;
+  static const int MAX_UPLOAD_TIMEOUTS = 3; // Of recv_wait_timeout each
+
+  // Requests served since boot, by path
+  uint32_t requests = 0;
+  uint32_t tornReads = 0; // Snapshot changed mid-send; the response was cut off
+
+  MetricsServer(PerfStats &perf, LatencyHistogram &fetchLatency, LatencySamples &inputLatency, WiFiLink &wifi,
+                LocationWeather *locations, const Location *table, int count, const int &current)
+      : perf(perf), fetchLatency(fetchLatency), inputLatency(inputLatency), wifi(wifi), locations(locations), table(table),
+        count(count), current(current) {}
+
+#ifdef ASSET_PACK
+  // Take asset pack uploads into store - call before begin()
+  void acceptAssets(AssetStore *store) { assets = store; }
+#endif
+
+  bool begin()
+  {
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = PORT;
+    config.stack_size = STACK_SIZE;
+    config.core_id = 0;
+    config.task_priority = tskIDLE_PRIORITY + 1;
+    config.max_open_sockets = 1;
+    config.lru_purge_enable = true; // A new scraper replaces a stuck one
+    config.recv_wait_timeout = 5;
+    config.send_wait_timeout = 5;
+    if (httpd_start(&server, &config) != ESP_OK)
+    {
+      Serial.println("Metrics: HTTP server failed to start");
+      return false;
+    }
+
+    static const struct
+    {
+      const char *uri;
+      esp_err_t (*handler)(httpd_req_t *);
+    } routes[] = {
+        {"/metrics", serveMetrics},
+        {"/weather.bin", serveBinary},
+        {"/weather.json", serveJson},
+    };
+    for (const auto &route : routes)
+    {
+      httpd_uri_t uri = {};
+      uri.uri = route.uri;
+      uri.method = HTTP_GET;
+      uri.handler = route.handler;
+      uri.user_ctx = this;
+      httpd_register_uri_handler(server, &uri);
+    }
+#ifdef ASSET_PACK
+#ifdef ASSET_UPLOAD_TOKEN
+    if (assets != nullptr)
+    {
+      httpd_uri_t uri = {};
+      uri.uri = "/assets";
+      uri.method = HTTP_PUT;
+      uri.handler = receiveAssets;
+      uri.user_ctx = this;
+      httpd_register_uri_handler(server, &uri);
+    }
+#else
+    Serial.println("Metrics: no ASSET_UPLOAD_TOKEN - asset uploads off");
+#endif
+#endif
+    Serial.printf("Metrics: serving on port %u\n", PORT);
+    return true;
+  }
+
+private:
+  PerfStats &perf;
+  LatencyHistogram &fetchLatency;
+  LatencySamples &inputLatency;
+  WiFiLink &wifi;
+  LocationWeather *locations;
+  const Location *table;
+  int count;
+  const int &current; // Location on screen (render side)
+  httpd_handle_t server = nullptr;
+#ifdef ASSET_PACK
+  AssetStore *assets = nullptr;
+#endif
+
+  static MetricsServer &self(httpd_req_t *req) { return *(MetricsServer *)req->user_ctx; }
+
+  // Frame probes, labelled by screen
+  static bool isFrameProbe(int probe) { return probe <= PROBE_DISPLAY_DEMO3; }
+
+  static void probeSummary(ChunkWriter &out, const char *metric, const char *label, const PerfStats::Probe &p)
+  {
+    out.printf("%s_sum%s %.6f\n", metric, label, p.sumUs / 1e6);
+    out.printf("%s_count%s %lu\n", metric, label, (unsigned long)p.totalCount);
+  }
+
+  static esp_err_t serveMetrics(httpd_req_t *req)
+  {
+    MetricsServer &m = self(req);
+    m.requests++;
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+    ChunkWriter out(req);
+
+    // Fetch latency, request to end of body
+    const LatencyHistogram &h = m.fetchLatency;
+    out.printf("# HELP weather_fetch_duration_seconds Weather fetch time, request to end of body.\n"
+               "# TYPE weather_fetch_duration_seconds histogram\n");
+    uint32_t cumulative = 0;
+    for (int b = 0; b < LatencyHistogram::BUCKETS; b++)
+    {
+      cumulative += h.counts[b];
+      out.printf("weather_fetch_duration_seconds_bucket{le=\"%g\"} %lu\n", LatencyHistogram::BOUNDS_MS[b] / 1000.0,
+                 (unsigned long)cumulative);
+    }
+    out.printf("weather_fetch_duration_seconds_bucket{le=\"+Inf\"} %lu\n", (unsigned long)h.count);
+    out.printf("weather_fetch_duration_seconds_sum %.3f\n", h.sumMs / 1000.0);
+    out.printf("weather_fetch_duration_seconds_count %lu\n", (unsigned long)h.count);
+
+    // The body is parsed as it streams in, so parse time includes the download
+    out.printf("# HELP weather_parse_seconds Response body read and parse time.\n"
+               "# TYPE weather_parse_seconds summary\n");
+    probeSummary(out, "weather_parse_seconds", "", m.perf.get(PROBE_FETCH_BODY));
+
+    out.printf("# HELP weather_frame_seconds Time to draw and push one frame, by screen.\n"
+               "# TYPE weather_frame_seconds summary\n");
+    for (int i = 0; i < PROBE_COUNT; i++)
+    {
+      if (!isFrameProbe(i))
+        continue;
+      char label[32];
+      snprintf(label, sizeof(label), "{screen=\"%s\"}", PerfStats::name((PerfProbe)i));
+      probeSummary(out, "weather_frame_seconds", label, m.perf.get((PerfProbe)i));
+    }
+    out.printf("# HELP weather_push_seconds Time to send a frame to the panel.\n"
+               "# TYPE weather_push_seconds summary\n");
+    probeSummary(out, "weather_push_seconds", "", m.perf.get(PROBE_PUSH));
+
+    // Button edge to the answering frame on the panel, over recent presses
+    out.printf("# HELP weather_input_latency_seconds Button edge to frame pushed, recent presses.\n"
+               "# TYPE weather_input_latency_seconds summary\n");
+    out.printf("weather_input_latency_seconds{quantile=\"0.5\"} %.4f\n", m.inputLatency.percentile(50) / 1e6);
+    out.printf("weather_input_latency_seconds{quantile=\"0.99\"} %.4f\n", m.inputLatency.percentile(99) / 1e6);
+    out.printf("weather_input_latency_seconds_count %lu\n", (unsigned long)m.inputLatency.count);
+
+    MemoryStats mem = m.perf.memory();
+    out.printf("# TYPE weather_heap_free_bytes gauge\nweather_heap_free_bytes %u\n", (unsigned)mem.heapFree);
+    out.printf("# TYPE weather_heap_min_free_bytes gauge\nweather_heap_min_free_bytes %u\n", (unsigned)mem.heapMinFree);
+    out.printf("# TYPE weather_heap_largest_block_bytes gauge\nweather_heap_largest_block_bytes %u\n",
+               (unsigned)mem.largestBlock);
+
+    bool online = m.wifi.hasIp();
+    out.printf("# TYPE weather_wifi_rssi_dbm gauge\nweather_wifi_rssi_dbm %d\n", online ? (int)WiFi.RSSI() : 0);
+    out.printf("# TYPE weather_wifi_reconnects_total counter\nweather_wifi_reconnects_total %lu\n",
+               (unsigned long)(m.wifi.joins > 0 ? m.wifi.joins - 1 : 0));
+    out.printf("# TYPE weather_uptime_seconds counter\nweather_uptime_seconds %lu\n", (unsigned long)(millis() / 1000));
+
+    out.printf("# HELP weather_data_age_seconds Age of the newest good forecast, by location.\n"
+               "# TYPE weather_data_age_seconds gauge\n");
+    time_t now = time(NULL);
+    for (int i = 0; i < m.count; i++)
+    {
+      time_t at = m.locations[i].lastGoodFetch;
+      out.printf("weather_data_age_seconds{location=\"%s\"} %ld\n", m.table[i].name, at > 0 ? (long)(now - at) : -1L);
+    }
+
+#ifdef ASSET_PACK
+    if (m.assets != nullptr)
+      out.printf("# TYPE weather_asset_pack_version gauge\nweather_asset_pack_version %lu\n",
+                 (unsigned long)m.assets->version());
+#endif
+    out.printf("# TYPE weather_http_requests_total counter\nweather_http_requests_total %lu\n", (unsigned long)m.requests);
+    return out.finish() ? ESP_OK : ESP_FAIL;
+  }
+
+  // The snapshot to send: current location's newest published buffer.
+  // nullptr (after a 503) while the fetch side is writing one.
+  static const WeatherData *beginSnapshot(httpd_req_t *req, LocationWeather *&loc, uint32_t &stamp)
+  {
+    MetricsServer &m = self(req);
+    m.requests++;
+    loc = &m.locations[m.current];
+    stamp = loc->writes.load();
+    const WeatherData *data = &loc->buffers[loc->published];
+    if ((stamp & 1) || !data->dataValid)
+    {
+      httpd_resp_set_status(req, "503 Service Unavailable");
+      httpd_resp_set_hdr(req, "Retry-After", "1");
+      httpd_resp_sendstr(req, "No snapshot ready\n");
+      return nullptr;
+    }
+    return data;
+  }
+
+  // Whether the buffer stayed put for the whole send. If not, the response
+  // is cut short (no final chunk) so the client sees an error, not a mix.
+  static esp_err_t endSnapshot(httpd_req_t *req, const LocationWeather *loc, uint32_t stamp, bool sent)
+  {
+    if (loc->writes.load() != stamp)
+    {
+      self(req).tornReads++;
+      return ESP_FAIL;
+    }
+    if (!sent || httpd_resp_send_chunk(req, nullptr, 0) != ESP_OK)
+      return ESP_FAIL;
+    return ESP_OK;
+  }
+
+  static esp_err_t serveBinary(httpd_req_t *req)
+  {
+    LocationWeather *loc;
+    uint32_t stamp;
+    const WeatherData *data = beginSnapshot(req, loc, stamp);
+    if (data == nullptr)
+      return ESP_OK;
+
+    char layout[24];
+    snprintf(layout, sizeof(layout), "%u/%u", (unsigned)WeatherCache::VERSION, (unsigned)sizeof(WeatherData));
+    char fetched[16];
+    snprintf(fetched, sizeof(fetched), "%ld", (long)loc->lastGoodFetch);
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "X-Weather-Layout", layout); // Snapshot version / struct size
+    httpd_resp_set_hdr(req, "X-Weather-Fetched", fetched);
+
+    const char *bytes = (const char *)data;
+    bool sent = true;
+    for (size_t offset = 0; offset < sizeof(WeatherData) && sent; offset += BIN_CHUNK)
+    {
+      size_t len = min((size_t)BIN_CHUNK, sizeof(WeatherData) - offset);
+      sent = httpd_resp_send_chunk(req, bytes + offset, len) == ESP_OK;
+    }
+    return endSnapshot(req, loc, stamp, sent);
+  }
+
+  static esp_err_t serveJson(httpd_req_t *req)
+  {
+    LocationWeather *loc;
+    uint32_t stamp;
+    const WeatherData *data = beginSnapshot(req, loc, stamp);
+    if (data == nullptr)
+      return ESP_OK;
+
+    MetricsServer &m = self(req);
+    const WeatherData &d = *data;
+    httpd_resp_set_type(req, "application/json");
+    ChunkWriter out(req);
+    out.printf("{\"location\":\"%s\",\"fetched\":%ld,\"stale\":%s,", m.table[m.current].name, (long)loc->lastGoodFetch,
+               loc->lastFetchOk ? "false" : "true");
+    out.printf("\"current\":{\"temp\":%.1f,\"feelsLike\":%.1f,\"humidity\":%d,\"windSpeed\":%.1f,\"windDeg\":%d,"
+               "\"weatherCode\":%d,\"condition\":\"",
+               d.temperature, d.apparent_temp, d.humidity, d.windSpeed, d.windDeg, d.weatherCode);
+    jsonText(out, d.condition);
+    out.printf("\",\"uvi\":%.1f,\"visibility\":%d,\"pressure\":%d,\"dewPoint\":%.1f,\"clouds\":%d,"
+               "\"sunrise\":%ld,\"sunset\":%ld,\"moonrise\":%ld,\"moonset\":%ld,\"moonPhase\":%.2f},",
+               d.uvi, d.visibility, d.pressure, d.dewPoint, d.clouds, (long)d.sunrise, (long)d.sunset,
+               (long)d.moonrise, (long)d.moonset, d.moonPhase);
+
+    out.printf("\"minutely\":");
+    if (d.hasMinutelyData)
+    {
+      for (int i = 0; i < 60; i++)
+        out.printf("%c%.2f", i == 0 ? '[' : ',', d.minutelyRain[i]);
+      out.printf("],");
+    }
+    else
+    {
+      out.printf("null,");
+    }
+
+    out.printf("\"hourly\":[");
+    for (int i = 0; i < d.hourlyCount; i++)
+      out.printf("%s{\"hour\":%d,\"temp\":%.1f,\"weatherCode\":%d}", i == 0 ? "" : ",", d.hourly[i].hour,
+                 d.hourly[i].temperature, d.hourly[i].weatherCode);
+
+    out.printf("],\"daily\":[");
+    for (int i = 0; i < d.dailyCount; i++)
+    {
+      const DailyData &day = d.daily[i];
+      out.printf("%s{\"day\":\"%s\",\"min\":%.1f,\"max\":%.1f,\"weatherCode\":%d,\"pop\":%d,\"summary\":\"",
+                 i == 0 ? "" : ",", day.dayName, day.tempMin, day.tempMax, day.weatherCode, day.pop);
+      jsonText(out, day.summary);
+      out.printf("\"}");
+    }
+
+    out.printf("],\"sectionUpdated\":[%ld,%ld,%ld,%ld]}\n", (long)d.sectionUpdated[SECTION_CURRENT],
+               (long)d.sectionUpdated[SECTION_MINUTELY], (long)d.sectionUpdated[SECTION_HOURLY],
+               (long)d.sectionUpdated[SECTION_DAILY]);
+    return endSnapshot(req, loc, stamp, out.flush());
+  }
+
+#if defined(ASSET_PACK) && defined(ASSET_UPLOAD_TOKEN)
+  // Authorization: Bearer ASSET_UPLOAD_TOKEN
+  static bool uploadAllowed(httpd_req_t *req)
+  {
+    static const char EXPECTED[] = "Bearer " ASSET_UPLOAD_TOKEN;
+    char given[sizeof(EXPECTED) + 1] = {};
+    if (httpd_req_get_hdr_value_str(req, "Authorization", given, sizeof(given)) != ESP_OK)
+      return false;
+    // Compare every byte, so the time taken doesn't reveal the matching prefix
+    uint8_t diff = strlen(given) != strlen(EXPECTED);
+    for (size_t i = 0; i < sizeof(EXPECTED); i++)
+      diff |= given[i] ^ EXPECTED[i];
+    return diff == 0;
+  }
+
+  static esp_err_t assetReply(httpd_req_t *req, const char *status, const char *text)
+  {
+    httpd_resp_set_status(req, status);
+    httpd_resp_sendstr(req, text);
+    return ESP_OK;
+  }
+
+  // Stream the body into the free asset slot; the render loop switches to
+  // it on its next pass. Flash writes stall both cores' caches, so the
+  // screen can stutter for the second or so this takes.
+  static esp_err_t receiveAssets(httpd_req_t *req)
+  {
+    MetricsServer &m = self(req);
+    m.requests++;
+    if (!uploadAllowed(req))
+      return assetReply(req, "401 Unauthorized", "Upload token missing or wrong\n");
+
+    size_t total = req->content_len;
+    if (!m.assets->beginUpdate(total))
+      return assetReply(req, "409 Conflict", "Pack too large, or the last one isn't in use yet\n");
+
+    char buf[BIN_CHUNK];
+    size_t received = 0;
+    int timeouts = 0;
+    while (received < total)
+    {
+      // The server has one socket, so a stalled upload would lock out
+      // /metrics - give up on it after a few receive timeouts
+      int n = httpd_req_recv(req, buf, min(sizeof(buf), total - received));
+      if (n == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts <= MAX_UPLOAD_TIMEOUTS)
+        continue;
+      if (n <= 0)
+        return ESP_FAIL; // Client gone or stalled; the slot fails its CRC and is never used
+      if (!m.assets->writeUpdate(buf, n))
+        return assetReply(req, "500 Internal Server Error", "Flash write failed\n");
+      received += n;
+    }
+
+    const char *error = m.assets->finishUpdate();
+    if (error != nullptr)
+    {
+      char text[64];
+      snprintf(text, sizeof(text), "Rejected: %s\n", error);
+      return assetReply(req, "400 Bad Request", text);
+    }
+    return assetReply(req, "200 OK", "Installed\n");
+  }
+#endif
+
+  // OWM text with quotes, backslashes and control characters escaped
+  static void jsonText(ChunkWriter &out, const char *text)
+  {
+    char run[64];
+    size_t n = 0;
+    for (const char *p = text; *p != '\0'; p++)
+    {
+      if (n > sizeof(run) - 8)
+      {
+        run[n] = '\0';
+        out.printf("%s", run);
+        n = 0;
+      }
+      unsigned char c = *p;
+      if (c == '"' || c == '\\')
+      {
+        run[n++] = '\\';
+        run[n++] = c;
+      }
+      else if (c < 0x20)
+      {
+        n += snprintf(run + n, sizeof(run) - n, "\\u%04x", c);
+      }
+      else
+      {
+        run[n++] = c;
+      }
+    }
+    run[n] = '\0';
+    out.printf("%s", run);
+  }
+};
+
+#endif // METRICS_SERVER_H
@@ -0,0 +1,106 @@
+/*
+ * Colour Palette for Weather Display
+ *
+ * The fixed set of colours every screen draws with. Normally these are
+ * RGB565 values. With PALETTE_FRAME they are slot numbers in the 16-entry
+ * palette of the 4 bpp frame sprite, and framePalette() holds the RGB565
+ * value of each slot.
+ */
+
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+#ifdef PALETTE_FRAME
+// Palette slots. Near-duplicate colours share a slot to leave room for the
+// two temperature gradient midpoints.
+#define COLOR_BG 0
+#define COLOR_TEXT 1
+#define COLOR_SUBTLE 2
+#define COLOR_RAIN_BG 3
+#define COLOR_SUN 4
+#define COLOR_CLOUD 5
+#define COLOR_CLOUD_MID 6
+#define COLOR_CLOUD_DARK 7
+#define COLOR_RAIN 8
+#define COLOR_SNOW 9
+#define COLOR_SUCCESS 10
+#define COLOR_ACCENT 11
+#define COLOR_ALERT 12
+#define COLOR_EXTREME 13
+#define COLOR_TEMP_COOL 14 // Midpoint of the blue -> white gradient
+#define COLOR_TEMP_WARM 15 // Midpoint of the white -> orange gradient
+#define COLOR_BOLT COLOR_SUN
+#define COLOR_DAYTIME COLOR_TEXT
+#define COLOR_MOON COLOR_SNOW
+#define COLOR_OVERCAST COLOR_CLOUD_DARK
+
+#define PALETTE_SIZE 16
+
+// RGB565 value of each slot, in slot order
+inline const uint16_t *framePalette()
+{
+  static const uint16_t colors[PALETTE_SIZE] = {
+      0x0000, 0xD69A, 0x8410, 0x0A1F, 0xFE60, 0x8C71, 0x6B6D, 0x4228,
+      0x001F, 0xBDF7, 0x3666, 0xFD20, 0xF800, 0xF81F, 0x7BFF, 0xFD90};
+  return colors;
+}
+
+// RGB565 value of a palette colour, for drawing straight to the panel
+inline uint16_t panelColor(uint16_t color)
+{
+  return framePalette()[color & (PALETTE_SIZE - 1)];
+}
+
+// Nearest palette slot to an arbitrary colour
+inline uint16_t frameColor(uint8_t r, uint8_t g, uint8_t b)
+{
+  const uint16_t *colors = framePalette();
+  uint16_t best = 0;
+  int32_t bestDist = INT32_MAX;
+  for (int i = 0; i < PALETTE_SIZE; i++)
+  {
+    int dr = ((colors[i] >> 8) & 0xF8) - r;
+    int dg = ((colors[i] >> 3) & 0xFC) - g;
+    int db = ((colors[i] << 3) & 0xF8) - b;
+    int32_t dist = dr * dr + dg * dg + db * db;
+    if (dist < bestDist)
+    {
+      bestDist = dist;
+      best = i;
+    }
+  }
+  return best;
+}
+#else
+// Color palette - elegant dark mode
+#define COLOR_BG 0x0000         // Pure black
+#define COLOR_TEXT 0xD69A       // Soft white (toned down)
+#define COLOR_SUBTLE 0x8410     // Grey for secondary text
+#define COLOR_RAIN_BG 0x0A1F    // Very dark blue for rain bars
+#define COLOR_SUN 0xFE60        // Warm yellow
+#define COLOR_CLOUD 0x8C71      // Light grey (highlight) - toned down
+#define COLOR_CLOUD_MID 0x6B6D  // Medium grey
+#define COLOR_CLOUD_DARK 0x4228 // Dark grey (shadow)
+#define COLOR_RAIN TFT_BLUE     // Pure blue for rain/humidity
+#define COLOR_BOLT 0xFFE0       // Yellow for lightning
+#define COLOR_SNOW 0xBDF7       // Light blue-white for snow
+#define COLOR_SUCCESS 0x3666    // Muted green
+#define COLOR_ACCENT 0xFD20     // Orange accent
+#define COLOR_DAYTIME 0xFFDB    // Cornsilk #FFF8DC
+#define COLOR_MOON 0x9CD3       // Grey moon, slightly lighter than clouds
+#define COLOR_OVERCAST 0x4208   // Darker grey for overcast
+#define COLOR_ALERT TFT_RED     // Errors, offline, very high UV
+#define COLOR_EXTREME 0xF81F    // Magenta for extreme UV
+
+inline uint16_t panelColor(uint16_t color) { return color; }
+
+constexpr uint16_t frameColor(uint8_t r, uint8_t g, uint8_t b)
+{
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+#endif
+
+#endif // PALETTE_H
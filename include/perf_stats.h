@@ -0,0 +1,255 @@
+/*
+ * Performance Instrumentation for Weather Display
+ *
+ * Fixed set of timing probes (count / average / max / last, in
+ * microseconds) plus heap and stack snapshots. ScopedTimer records the
+ * lifetime of a block into a probe. report() streams one JSON line per
+ * interval over Serial so builds can be compared by graphing the logs;
+ * running totals that report() never resets back the /metrics endpoint.
+ */
+
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <algorithm>
+
+enum PerfProbe
+{
+  PROBE_DISPLAY_HOURLY,
+  PROBE_DISPLAY_HOURLY2,
+  PROBE_DISPLAY_CONDITIONS,
+  PROBE_DISPLAY_DAILY,
+  PROBE_DISPLAY_SETTINGS,
+  PROBE_DISPLAY_ABOUT,
+  PROBE_DISPLAY_DEMO,
+  PROBE_DISPLAY_DEMO2,
+  PROBE_DISPLAY_DEMO3,
+  PROBE_PUSH,
+  PROBE_ICON,
+  PROBE_FETCH_DNS,
+  PROBE_FETCH_CONNECT,    // TCP + TLS handshake
+  PROBE_FETCH_FIRST_BYTE, // Request sent to status line
+  PROBE_FETCH_BODY,       // Download and parse - the JSON is parsed as it streams in
+  PROBE_FETCH_TOTAL,
+  PROBE_COUNT
+};
+
+#define PROBE_BIT(p) (1u << (p))
+// Probes timing a whole frame, batched while a frame is drawn in bands
+#define PERF_FRAME_PROBES (PROBE_BIT(PROBE_DISPLAY_HOURLY) | PROBE_BIT(PROBE_DISPLAY_HOURLY2) |          \
+                           PROBE_BIT(PROBE_DISPLAY_CONDITIONS) | PROBE_BIT(PROBE_DISPLAY_DAILY) |        \
+                           PROBE_BIT(PROBE_DISPLAY_SETTINGS) | PROBE_BIT(PROBE_DISPLAY_ABOUT) |          \
+                           PROBE_BIT(PROBE_DISPLAY_DEMO) | PROBE_BIT(PROBE_DISPLAY_DEMO2) |              \
+                           PROBE_BIT(PROBE_DISPLAY_DEMO3) | PROBE_BIT(PROBE_PUSH))
+
+// Memory snapshot, bytes
+struct MemoryStats
+{
+  uint32_t heapFree;
+  uint32_t heapMinFree;
+  uint32_t largestBlock;
+  uint32_t loopStackFree;  // High-water mark: least stack ever left
+  uint32_t fetchStackFree;
+};
+
+class PerfStats
+{
+public:
+  struct Probe
+  {
+    uint32_t count;
+    uint64_t totalUs;
+    uint32_t maxUs;
+    uint32_t lastUs; // Survives report() resets, for live display
+    // Since boot, never reset - for scrapers that compute their own rates
+    uint32_t totalCount;
+    uint64_t sumUs;
+  };
+
+  // Each probe is written by one task only; readers on other tasks may see
+  // a sample mid-update, which is fine for statistics
+  void record(PerfProbe probe, uint32_t us)
+  {
+    if (batchMask & PROBE_BIT(probe))
+    {
+      batched[probe] += us;
+      batchTouched |= PROBE_BIT(probe);
+      return;
+    }
+    Probe &p = probes[probe];
+    p.count++;
+    p.totalUs += us;
+    if (us > p.maxUs)
+      p.maxUs = us;
+    p.lastUs = us;
+    p.totalCount++;
+    p.sumUs += us;
+  }
+
+  // Between beginBatch() and endBatch() the probes in mask add up their
+  // samples, and each is recorded once at the end (a frame drawn in
+  // several passes counts as one frame). Render task only.
+  void beginBatch(uint32_t mask)
+  {
+    batchMask = mask;
+    batchTouched = 0;
+    memset(batched, 0, sizeof(batched));
+  }
+
+  void endBatch()
+  {
+    batchMask = 0;
+    for (int i = 0; i < PROBE_COUNT; i++)
+    {
+      if (batchTouched & PROBE_BIT(i))
+        record((PerfProbe)i, batched[i]);
+    }
+  }
+
+  const Probe &get(PerfProbe probe) const { return probes[probe]; }
+  static const char *name(PerfProbe probe) { return PROBE_NAMES[probe]; }
+
+  uint32_t averageUs(PerfProbe probe) const
+  {
+    const Probe &p = probes[probe];
+    return p.count > 0 ? (uint32_t)(p.totalUs / p.count) : 0;
+  }
+
+  void setTasks(TaskHandle_t loopTask, TaskHandle_t fetchTask)
+  {
+    this->loopTask = loopTask;
+    this->fetchTask = fetchTask;
+  }
+
+  MemoryStats memory() const
+  {
+    MemoryStats m;
+    m.heapFree = ESP.getFreeHeap();
+    m.heapMinFree = ESP.getMinFreeHeap();
+    m.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    m.loopStackFree = loopTask != nullptr ? uxTaskGetStackHighWaterMark(loopTask) : 0;
+    m.fetchStackFree = fetchTask != nullptr ? uxTaskGetStackHighWaterMark(fetchTask) : 0;
+    return m;
+  }
+
+  // One JSON line: {"perf":1,"fw":...,"ms":...,"mem":{...},"probes":{"name":[count,avg,max],...}}
+  // then reset the per-interval counts
+  void report()
+  {
+    MemoryStats m = memory();
+    Serial.printf("{\"perf\":1,\"fw\":\"%s %s\",\"ms\":%lu,\"mem\":{\"free\":%u,\"minFree\":%u,"
+                  "\"largest\":%u,\"loopStack\":%u,\"fetchStack\":%u},\"probes\":{",
+                  __DATE__, __TIME__, (unsigned long)millis(), (unsigned)m.heapFree, (unsigned)m.heapMinFree,
+                  (unsigned)m.largestBlock, (unsigned)m.loopStackFree, (unsigned)m.fetchStackFree);
+    bool first = true;
+    for (int i = 0; i < PROBE_COUNT; i++)
+    {
+      Probe &p = probes[i];
+      if (p.count == 0)
+        continue;
+      Serial.printf("%s\"%s\":[%lu,%lu,%lu]", first ? "" : ",", PROBE_NAMES[i], (unsigned long)p.count,
+                    (unsigned long)(p.totalUs / p.count), (unsigned long)p.maxUs);
+      first = false;
+      p.count = 0;
+      p.totalUs = 0;
+      p.maxUs = 0;
+    }
+    Serial.println("}}");
+  }
+
+private:
+  static constexpr const char *PROBE_NAMES[PROBE_COUNT] = {
+      "hourly", "hourly2", "conditions", "daily", "settings", "about", "demo", "demo2", "demo3",
+      "push", "icon", "dns", "connect", "firstByte", "body", "fetch"};
+
+  Probe probes[PROBE_COUNT] = {};
+  uint32_t batchMask = 0;
+  uint32_t batchTouched = 0;
+  uint32_t batched[PROBE_COUNT] = {};
+  TaskHandle_t loopTask = nullptr;
+  TaskHandle_t fetchTask = nullptr;
+};
+
+// Cumulative latency histogram with fixed bucket bounds, in the shape
+// Prometheus expects. One writer; readers may see a sample mid-update.
+class LatencyHistogram
+{
+public:
+  static const int BUCKETS = 8;
+  static constexpr uint32_t BOUNDS_MS[BUCKETS] = {100, 250, 500, 1000, 2000, 4000, 8000, 16000};
+
+  uint32_t counts[BUCKETS + 1] = {}; // Last one is above every bound (+Inf)
+  uint32_t count = 0;
+  uint64_t sumMs = 0;
+
+  void record(uint32_t ms)
+  {
+    int b = 0;
+    while (b < BUCKETS && ms > BOUNDS_MS[b])
+      b++;
+    counts[b]++;
+    count++;
+    sumMs += ms;
+  }
+};
+
+// The most recent SIZE samples of a latency, for percentiles. One writer;
+// readers may see a sample mid-update.
+class LatencySamples
+{
+public:
+  static const int SIZE = 128;
+
+  uint32_t count = 0; // Since boot
+  uint32_t maxUs = 0;
+
+  void record(uint32_t us)
+  {
+    samples[count % SIZE] = us;
+    count++;
+    if (us > maxUs)
+      maxUs = us;
+  }
+
+  // Nearest-rank percentile (0-100) of the samples held, 0 with none
+  uint32_t percentile(int p) const
+  {
+    int n = min(count, (uint32_t)SIZE);
+    if (n == 0)
+      return 0;
+    uint32_t sorted[SIZE];
+    memcpy(sorted, samples, n * sizeof(uint32_t));
+    std::sort(sorted, sorted + n);
+    int rank = (p * n + 99) / 100;
+    return sorted[max(rank, 1) - 1];
+  }
+
+  void report(const char *name) const
+  {
+    if (count == 0)
+      return;
+    Serial.printf("%s: p50 %.1f ms, p99 %.1f ms, max %.1f ms over the last %d of %lu\n", name,
+                  percentile(50) / 1000.0, percentile(99) / 1000.0, maxUs / 1000.0, (int)min(count, (uint32_t)SIZE),
+                  (unsigned long)count);
+  }
+
+private:
+  uint32_t samples[SIZE] = {};
+};
+
+// Times the enclosing block into a probe
+class ScopedTimer
+{
+public:
+  ScopedTimer(PerfStats &stats, PerfProbe probe) : stats(stats), probe(probe), start(micros()) {}
+  ~ScopedTimer() { stats.record(probe, micros() - start); }
+
+private:
+  PerfStats &stats;
+  PerfProbe probe;
+  unsigned long start;
+};
+
+#endif // PERF_STATS_H
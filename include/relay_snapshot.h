@@ -0,0 +1,187 @@
+/*
+ * Relay Snapshot Format for Weather Display
+ *
+ * The compact MessagePack snapshot served by the LAN relay
+ * (tools/relay/owm_relay.py) in place of the One Call JSON. It carries
+ * only the fields WeatherData keeps, as positional arrays, so there are
+ * no keys to match and no filter to run. Keep the field order here in
+ * step with the relay and bump the version on any change.
+ *
+ *   [version, sections, current, minutely, hourly, daily]
+ *   current  = [temp, feels_like, humidity, wind_speed, wind_deg, weather_id,
+ *               description, sunrise, sunset, uvi, visibility, pressure,
+ *               dew_point, clouds]
+ *   minutely = [precipitation, ...]                     up to 60
+ *   hourly   = [[dt, temp, weather_id], ...]            up to 24
+ *   daily    = [moonrise, moonset, moon_phase,
+ *               [[dt, min, max, weather_id, pop_percent, summary], ...]]  up to 8
+ *
+ * sections is a SECTION_BIT mask of what the relay filled in; the others
+ * are nil.
+ */
+
+#ifndef RELAY_SNAPSHOT_H
+#define RELAY_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <time.h>
+#include "types.h"
+#include "helpers.h"
+
+#define RELAY_SNAPSHOT_VERSION 1
+
+enum RelaySnapshotField
+{
+  SNAP_VERSION,
+  SNAP_SECTIONS,
+  SNAP_CURRENT,
+  SNAP_MINUTELY,
+  SNAP_HOURLY,
+  SNAP_DAILY
+};
+
+enum RelayCurrentField
+{
+  CUR_TEMP,
+  CUR_FEELS_LIKE,
+  CUR_HUMIDITY,
+  CUR_WIND_SPEED,
+  CUR_WIND_DEG,
+  CUR_WEATHER_ID,
+  CUR_DESCRIPTION,
+  CUR_SUNRISE,
+  CUR_SUNSET,
+  CUR_UVI,
+  CUR_VISIBILITY,
+  CUR_PRESSURE,
+  CUR_DEW_POINT,
+  CUR_CLOUDS
+};
+
+enum RelayHourField
+{
+  HOUR_DT,
+  HOUR_TEMP,
+  HOUR_WEATHER_ID
+};
+
+enum RelayDailyField
+{
+  DAILY_MOONRISE,
+  DAILY_MOONSET,
+  DAILY_MOON_PHASE,
+  DAILY_DAYS
+};
+
+enum RelayDayField
+{
+  DAY_DT,
+  DAY_MIN,
+  DAY_MAX,
+  DAY_WEATHER_ID,
+  DAY_POP,
+  DAY_SUMMARY
+};
+
+// Copy the requested sections of a decoded snapshot into a WeatherData
+// buffer, leaving the other sections untouched. False if the snapshot is
+// from another schema version or lacks a requested section.
+inline bool parseRelaySnapshot(JsonDocument &doc, WeatherData &out, uint8_t sections)
+{
+  int version = doc[SNAP_VERSION] | 0;
+  if (version != RELAY_SNAPSHOT_VERSION)
+  {
+    Serial.printf("Relay snapshot version %d, expected %d\n", version, RELAY_SNAPSHOT_VERSION);
+    return false;
+  }
+  uint8_t present = doc[SNAP_SECTIONS] | 0;
+  if ((present & sections) != sections)
+  {
+    Serial.printf("Relay snapshot has sections 0x%x, asked for 0x%x\n", present, sections);
+    return false;
+  }
+
+  time_t now = time(NULL);
+
+  if (sections & SECTION_BIT(SECTION_CURRENT))
+  {
+    JsonArray current = doc[SNAP_CURRENT];
+    out.temperature = current[CUR_TEMP];
+    out.apparent_temp = current[CUR_FEELS_LIKE];
+    out.humidity = current[CUR_HUMIDITY];
+    out.windSpeed = current[CUR_WIND_SPEED];
+    out.windDeg = current[CUR_WIND_DEG];
+    out.windDir = degToCompass(out.windDeg);
+    out.weatherCode = current[CUR_WEATHER_ID];
+    strlcpy(out.condition, current[CUR_DESCRIPTION] | "", sizeof(out.condition));
+    out.condition[0] = toupper(out.condition[0]);
+    out.sunrise = current[CUR_SUNRISE].as<time_t>();
+    out.sunset = current[CUR_SUNSET].as<time_t>();
+    out.uvi = current[CUR_UVI];
+    out.visibility = current[CUR_VISIBILITY];
+    out.pressure = current[CUR_PRESSURE];
+    out.dewPoint = current[CUR_DEW_POINT];
+    out.clouds = current[CUR_CLOUDS];
+    out.sectionUpdated[SECTION_CURRENT] = now;
+  }
+
+  if (sections & SECTION_BIT(SECTION_MINUTELY))
+  {
+    // OWM leaves minutely out where it has no nowcast - the relay sends []
+    JsonArray minutely = doc[SNAP_MINUTELY];
+    int count = min((int)minutely.size(), 60);
+    out.hasMinutelyData = count > 0;
+    for (int i = 0; i < 60; i++)
+    {
+      out.minutelyRain[i] = i < count ? minutely[i].as<float>() : 0;
+    }
+    out.sectionUpdated[SECTION_MINUTELY] = now;
+  }
+
+  if (sections & SECTION_BIT(SECTION_HOURLY))
+  {
+    JsonArray hourly = doc[SNAP_HOURLY];
+    out.hourlyCount = min((int)hourly.size(), 24);
+    for (int i = 0; i < out.hourlyCount; i++)
+    {
+      JsonArray hour = hourly[i];
+      out.hourly[i].temperature = hour[HOUR_TEMP];
+      out.hourly[i].weatherCode = hour[HOUR_WEATHER_ID];
+      time_t ts = hour[HOUR_DT];
+      struct tm timeinfo;
+      localtime_r(&ts, &timeinfo); // Local hour on the device, not the relay
+      out.hourly[i].hour = timeinfo.tm_hour;
+    }
+    out.sectionUpdated[SECTION_HOURLY] = now;
+  }
+
+  if (sections & SECTION_BIT(SECTION_DAILY))
+  {
+    JsonArray daily = doc[SNAP_DAILY];
+    JsonArray days = daily[DAILY_DAYS];
+    out.dailyCount = min((int)days.size(), 8);
+    for (int i = 0; i < out.dailyCount; i++)
+    {
+      JsonArray day = days[i];
+      out.daily[i].tempMin = day[DAY_MIN];
+      out.daily[i].tempMax = day[DAY_MAX];
+      out.daily[i].weatherCode = day[DAY_WEATHER_ID];
+      out.daily[i].pop = day[DAY_POP];
+      strlcpy(out.daily[i].summary, day[DAY_SUMMARY] | "", sizeof(out.daily[i].summary));
+      time_t ts = day[DAY_DT];
+      struct tm timeinfo;
+      localtime_r(&ts, &timeinfo);
+      out.daily[i].dayName = shortDayName(timeinfo.tm_wday);
+    }
+    out.moonrise = daily[DAILY_MOONRISE].as<time_t>();
+    out.moonset = daily[DAILY_MOONSET].as<time_t>();
+    out.moonPhase = daily[DAILY_MOON_PHASE];
+    out.sectionUpdated[SECTION_DAILY] = now;
+  }
+
+  out.dataValid = true;
+  return true;
+}
+
+#endif // RELAY_SNAPSHOT_H
@@ -0,0 +1,232 @@
+/*
+ * Deadline Scheduler for Weather Display
+ *
+ * A fixed-size min-heap of periodic and one-shot jobs keyed by their next
+ * deadline. loop() runs whatever is due, then sleeps until the earliest
+ * deadline instead of polling. Each job keeps run count and timing stats.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include <limits.h>
+
+typedef void (*JobFn)();
+
+class Scheduler
+{
+public:
+  static const int MAX_JOBS = 8;
+  static const int NO_JOB = -1;
+  static const unsigned long NEVER = ULONG_MAX;
+
+  // Run fn every periodMs, first after firstDelayMs. Returns a job id or NO_JOB.
+  int every(const char *name, unsigned long periodMs, JobFn fn, unsigned long firstDelayMs)
+  {
+    return add(name, periodMs, fn, firstDelayMs);
+  }
+
+  // Run fn once after delayMs. Its slot is freed once it has run, unless it
+  // rescheduled itself, and the id may then be handed to a later job.
+  int after(const char *name, unsigned long delayMs, JobFn fn)
+  {
+    return add(name, 0, fn, delayMs);
+  }
+
+  // Move a job's next deadline to delayMs from now (also resumes a paused job)
+  void reschedule(int id, unsigned long delayMs)
+  {
+    if (!valid(id))
+      return;
+    Job &job = jobs[id];
+    if (job.heapPos >= 0)
+      removeAt(job.heapPos);
+    job.due = millis() + delayMs;
+    push(id);
+  }
+
+  // Take a job out of the heap without forgetting it
+  void pause(int id)
+  {
+    if (valid(id) && jobs[id].heapPos >= 0)
+      removeAt(jobs[id].heapPos);
+  }
+
+  void cancel(int id)
+  {
+    if (!valid(id))
+      return;
+    pause(id);
+    jobs[id].fn = nullptr;
+  }
+
+  bool isPending(int id) const
+  {
+    return valid(id) && jobs[id].heapPos >= 0;
+  }
+
+  // Run every job whose deadline has passed
+  void runDue()
+  {
+    unsigned long now = millis();
+    while (heapSize > 0 && (long)(now - jobs[heap[0]].due) >= 0)
+    {
+      int id = heap[0];
+      Job &job = jobs[id];
+      removeAt(0);
+
+      // Re-arm before running, so the job may reschedule or cancel itself
+      if (job.period > 0)
+      {
+        job.due += job.period;
+        if ((long)(now - job.due) >= 0)
+          job.due = now + job.period; // Fell behind - skip missed runs
+        push(id);
+      }
+
+      unsigned long start = micros();
+      job.fn();
+      unsigned long took = micros() - start;
+      job.runs++;
+      job.totalUs += took;
+      if (took > job.maxUs)
+        job.maxUs = took;
+      if (job.period == 0 && job.heapPos < 0)
+        job.fn = nullptr; // One-shot done - free the slot
+
+      now = millis();
+    }
+  }
+
+  // Milliseconds until the earliest deadline, 0 if overdue, NEVER if idle
+  unsigned long msUntilNext() const
+  {
+    if (heapSize == 0)
+      return NEVER;
+    long left = (long)(jobs[heap[0]].due - millis());
+    return left > 0 ? (unsigned long)left : 0;
+  }
+
+  // Print per-job run counts and timing, then reset them
+  void report()
+  {
+    for (int i = 0; i < MAX_JOBS; i++)
+    {
+      Job &job = jobs[i];
+      if (job.fn == nullptr || job.runs == 0)
+        continue;
+      Serial.printf("Job %-8s runs %4lu, avg %6lu us, max %6lu us\n", job.name,
+                    (unsigned long)job.runs, (unsigned long)(job.totalUs / job.runs),
+                    (unsigned long)job.maxUs);
+      job.runs = 0;
+      job.totalUs = 0;
+      job.maxUs = 0;
+    }
+  }
+
+private:
+  struct Job
+  {
+    const char *name = "";
+    JobFn fn = nullptr;
+    unsigned long period = 0; // 0 = one-shot
+    unsigned long due = 0;
+    int heapPos = -1;         // Index in heap, -1 when not scheduled
+    uint32_t runs = 0;
+    uint64_t totalUs = 0;
+    uint32_t maxUs = 0;
+  };
+
+  Job jobs[MAX_JOBS];
+  int heap[MAX_JOBS];
+  int heapSize = 0;
+
+  bool valid(int id) const
+  {
+    return id >= 0 && id < MAX_JOBS && jobs[id].fn != nullptr;
+  }
+
+  int add(const char *name, unsigned long period, JobFn fn, unsigned long delayMs)
+  {
+    for (int id = 0; id < MAX_JOBS; id++)
+    {
+      if (jobs[id].fn != nullptr)
+        continue;
+      jobs[id] = Job();
+      jobs[id].name = name;
+      jobs[id].fn = fn;
+      jobs[id].period = period;
+      jobs[id].due = millis() + delayMs;
+      push(id);
+      return id;
+    }
+    Serial.printf("Scheduler full, dropping job %s\n", name);
+    return NO_JOB;
+  }
+
+  // Deadlines compare by signed difference so millis() wrap-around is safe
+  bool before(int a, int b) const
+  {
+    return (long)(jobs[a].due - jobs[b].due) < 0;
+  }
+
+  void place(int pos, int id)
+  {
+    heap[pos] = id;
+    jobs[id].heapPos = pos;
+  }
+
+  void push(int id)
+  {
+    place(heapSize, id);
+    siftUp(heapSize++);
+  }
+
+  void removeAt(int pos)
+  {
+    int id = heap[pos];
+    jobs[id].heapPos = -1;
+    if (--heapSize == pos)
+      return;
+    place(pos, heap[heapSize]);
+    siftDown(pos);
+    siftUp(pos);
+  }
+
+  void siftUp(int pos)
+  {
+    while (pos > 0)
+    {
+      int parent = (pos - 1) / 2;
+      if (!before(heap[pos], heap[parent]))
+        break;
+      int id = heap[pos];
+      place(pos, heap[parent]);
+      place(parent, id);
+      pos = parent;
+    }
+  }
+
+  void siftDown(int pos)
+  {
+    for (;;)
+    {
+      int smallest = pos;
+      int left = 2 * pos + 1;
+      int right = left + 1;
+      if (left < heapSize && before(heap[left], heap[smallest]))
+        smallest = left;
+      if (right < heapSize && before(heap[right], heap[smallest]))
+        smallest = right;
+      if (smallest == pos)
+        return;
+      int id = heap[pos];
+      place(pos, heap[smallest]);
+      place(smallest, id);
+      pos = smallest;
+    }
+  }
+};
+
+#endif // SCHEDULER_H
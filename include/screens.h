@@ -0,0 +1,149 @@
+/*
+ * Screen Registry for Weather Display
+ *
+ * One descriptor per Screen: its navigation group and position, how it is
+ * drawn, the data it shows and when it needs redrawing. The table itself
+ * (SCREENS in main.cpp) is constexpr; these helpers check it at compile
+ * time and answer navigation and indicator questions from it, so adding
+ * a screen is one table row.
+ */
+
+#ifndef SCREENS_H
+#define SCREENS_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include "types.h"
+#include "perf_stats.h"
+
+// Screens cycled by left/right; the weather group wraps onto the next location
+enum ScreenGroup
+{
+  GROUP_WEATHER,
+  GROUP_SETTINGS
+};
+
+enum ScreenRefresh
+{
+  REFRESH_INPUTS, // Redrawn when one of its inputs changes
+  REFRESH_LIVE,   // Redrawn on every update, live lines every PERF_REFRESH_INTERVAL
+  REFRESH_STATIC  // Shows no data - drawn once, then restored from the frame cache
+};
+
+// Screen inputs: the SECTION_BIT of each section shown, plus the footer's
+// cached-forecast marking
+#define INPUT_STALE (1 << SECTION_COUNT)
+#define INPUTS_ALL 0xFF
+
+struct ScreenInfo
+{
+  Screen screen;
+  ScreenGroup group;
+  uint8_t order; // Position in its group - navigation order and indicator dot
+  void (*draw)();
+  PerfProbe probe;
+  uint8_t inputs; // Sections (and INPUT_STALE) it shows
+  ScreenRefresh refresh;
+  bool clock; // Header with the flashing colon
+};
+
+struct ScreenStep
+{
+  Screen screen;
+  bool wrapped; // Went round the end of the sequence
+};
+
+template <size_t N>
+constexpr int groupSize(const ScreenInfo (&table)[N], ScreenGroup group)
+{
+  int n = 0;
+  for (size_t i = 0; i < N; i++)
+    n += table[i].group == group;
+  return n;
+}
+
+// Every Screen at its own index, and each group numbered 0.. in table order
+template <size_t N>
+constexpr bool screenTableValid(const ScreenInfo (&table)[N])
+{
+  int next[2] = {0, 0};
+  for (size_t i = 0; i < N; i++)
+  {
+    if ((size_t)table[i].screen != i || table[i].order != next[table[i].group])
+      return false;
+    next[table[i].group]++;
+  }
+  return true;
+}
+
+// The screen of group at position order
+template <size_t N>
+constexpr Screen screenAt(const ScreenInfo (&table)[N], ScreenGroup group, int order)
+{
+  for (size_t i = 0; i < N; i++)
+  {
+    if (table[i].group == group && table[i].order == order)
+      return table[i].screen;
+  }
+  return table[0].screen;
+}
+
+// One step through from's group (dir +1 or -1), wrapping at either end
+template <size_t N>
+constexpr ScreenStep stepInGroup(const ScreenInfo (&table)[N], Screen from, int dir)
+{
+  const ScreenInfo &info = table[from];
+  int count = groupSize(table, info.group);
+  int order = info.order + dir;
+  bool wrapped = order < 0 || order >= count;
+  order = (order + count) % count;
+  return {screenAt(table, info.group, order), wrapped};
+}
+
+// Next screen of the whole table, for the auto-switch tour
+template <size_t N>
+constexpr ScreenStep stepAll(const ScreenInfo (&table)[N], Screen from)
+{
+  size_t next = (size_t)from + 1;
+  return {table[next % N].screen, next >= N};
+}
+
+// Whether a screen shows any of the inputs in changed
+constexpr bool showsInputs(const ScreenInfo &info, uint8_t changed)
+{
+  return info.refresh == REFRESH_LIVE || (info.refresh == REFRESH_INPUTS && (info.inputs & changed) != 0);
+}
+
+// What the screen on the panel was built from. New snapshots are compared
+// against it to find which inputs changed.
+struct ScreenInputs
+{
+  bool valid = false;
+  bool stale = false;
+  time_t sectionUpdated[SECTION_COUNT] = {};
+
+  // Inputs that differ in data/stale from what was last taken
+  uint8_t diff(const WeatherData &data, bool dataStale) const
+  {
+    if (data.dataValid != valid)
+      return INPUTS_ALL;
+    uint8_t changed = 0;
+    for (int s = 0; s < SECTION_COUNT; s++)
+    {
+      if (data.sectionUpdated[s] != sectionUpdated[s])
+        changed |= SECTION_BIT(s);
+    }
+    if (dataStale != stale)
+      changed |= INPUT_STALE;
+    return changed;
+  }
+
+  void take(const WeatherData &data, bool dataStale)
+  {
+    valid = data.dataValid;
+    stale = dataStale;
+    memcpy(sectionUpdated, data.sectionUpdated, sizeof(sectionUpdated));
+  }
+};
+
+#endif // SCREENS_H
@@ -0,0 +1,333 @@
+/*
+ * Snapshot Fan-out for Weather Display
+ *
+ * Leader/follower sharing of fetched forecasts over UDP multicast, so a
+ * room of displays makes one set of OWM calls. The leader fetches as usual
+ * and broadcasts each new snapshot (the checksummed WeatherSnapshot from
+ * weather_cache.h, in chunks); followers take it in place of a fetch.
+ *
+ * The leader sends a heartbeat every HEARTBEAT_MS. A unit that hears none
+ * for LEADER_TIMEOUT_MS (plus a per-node stagger) claims the role, and of
+ * two leaders that hear each other the lower node id keeps it. A follower
+ * that stops getting snapshots while the leader still beats fetches for
+ * itself again. All units must run the same firmware (snapshot layout and
+ * location table).
+ */
+
+#ifndef SNAPSHOT_FANOUT_H
+#define SNAPSHOT_FANOUT_H
+
+#include <Arduino.h>
+#include <AsyncUDP.h>
+#include <rom/crc.h>
+#include <atomic>
+#include "weather_cache.h"
+
+enum FanoutRole
+{
+  FANOUT_LISTENING, // Just joined - waiting to hear a leader before claiming
+  FANOUT_FOLLOWER,
+  FANOUT_LEADER
+};
+
+enum FanoutPacket
+{
+  FANOUT_HEARTBEAT,
+  FANOUT_HELLO, // A unit joined - the leader re-sends what it has
+  FANOUT_CHUNK
+};
+
+struct FanoutHeader
+{
+  uint32_t magic;
+  uint8_t version;
+  uint8_t type;       // FanoutPacket
+  uint8_t location;   // Index into LOCATIONS
+  uint8_t chunk;      // This chunk's index
+  uint8_t chunkCount; // Chunks in the snapshot
+  uint8_t reserved[3];
+  uint32_t node; // Sender
+  uint32_t seq;  // Snapshot number from this sender
+};
+
+template <int LOCATIONS>
+class SnapshotFanout
+{
+public:
+  static const uint32_t MAGIC = 0x5746414E; // "WFAN"
+  static const uint8_t VERSION = 1;
+  static const uint16_t PORT = 47474;
+  static const unsigned long HEARTBEAT_MS = 2000;
+  static const unsigned long LEADER_TIMEOUT_MS = 6000; // Three missed heartbeats
+  static const unsigned long STAGGER_MS = 500;         // Per node, so claims rarely collide
+  static const int CHUNK_BYTES = 1024;                 // Well inside one unfragmented datagram
+  static const int CHUNK_COUNT = (sizeof(WeatherSnapshot) + CHUNK_BYTES - 1) / CHUNK_BYTES;
+
+  // Counters since boot
+  uint32_t snapshotsSent = 0;
+  uint32_t snapshotsReceived = 0;
+  uint32_t snapshotsDropped = 0; // Bad checksum, or still waiting to be taken
+  uint32_t takeovers = 0;
+
+  explicit SnapshotFanout(IPAddress group) : group(group) {}
+
+  // Join the group - call whenever the link gets an address. wake runs on
+  // the network task when a snapshot or resend request arrives.
+  bool begin(void (*wake)())
+  {
+    this->wake = wake;
+    if (node == 0)
+    {
+      uint8_t mac[6];
+      WiFi.macAddress(mac);
+      node = crc32_le(0, mac, sizeof(mac)) | 1; // Never 0
+    }
+    if (listening)
+      udp.close();
+    listening = udp.listenMulticast(group, PORT);
+    if (!listening)
+    {
+      Serial.println("Fan-out: multicast listen failed");
+      return false;
+    }
+    udp.onPacket([this](AsyncUDPPacket &packet)
+                 { receive(packet.data(), packet.length()); });
+    joinedAt = millis();
+    if (currentRole != FANOUT_LEADER)
+      currentRole = FANOUT_LISTENING;
+    send(FANOUT_HELLO, 0, 0, 0, nullptr, 0);
+    Serial.printf("Fan-out: node %08lx listening\n", (unsigned long)node);
+    return true;
+  }
+
+  FanoutRole role() const { return currentRole; }
+  const char *roleName() const
+  {
+    static const char *const NAMES[] = {"listening", "follower", "leader"};
+    return NAMES[currentRole];
+  }
+
+  // Call every HEARTBEAT_MS. Sends the leader's heartbeat and takes over
+  // from a silent one. Returns true when this unit just became leader.
+  bool tick(unsigned long now)
+  {
+    if (!listening)
+      return false;
+    if (currentRole == FANOUT_LEADER)
+    {
+      send(FANOUT_HEARTBEAT, 0, 0, 0, nullptr, 0);
+      return false;
+    }
+
+    unsigned long heard = currentRole == FANOUT_FOLLOWER ? lastHeartbeat.load() : joinedAt;
+    if (now - heard < LEADER_TIMEOUT_MS + (node % 8) * STAGGER_MS)
+      return false;
+
+    if (currentRole == FANOUT_FOLLOWER)
+    {
+      takeovers++;
+      Serial.printf("Fan-out: leader %08lx silent - taking over\n", (unsigned long)leader);
+    }
+    else
+    {
+      Serial.println("Fan-out: no leader heard - leading");
+    }
+    currentRole = FANOUT_LEADER;
+    leader = node;
+    send(FANOUT_HEARTBEAT, 0, 0, 0, nullptr, 0);
+    return true;
+  }
+
+  // Whether a leader is keeping this unit fed: following, and a snapshot
+  // (or the switch to following) within windowMs
+  bool leaderFeeding(unsigned long now, unsigned long windowMs) const
+  {
+    if (currentRole != FANOUT_FOLLOWER)
+      return false;
+    unsigned long since = max(lastSnapshot.load(), followingSince.load());
+    return now - since < windowMs;
+  }
+
+  // Broadcast a fetched snapshot (leader only). Runs on the fetch task.
+  void share(int location, const WeatherData &data, time_t fetchedAt)
+  {
+    if (!listening || currentRole != FANOUT_LEADER)
+      return;
+    WeatherCache::pack(data, fetchedAt, outgoing);
+    const uint8_t *bytes = (const uint8_t *)&outgoing;
+    uint32_t seq = ++sendSeq;
+    for (int c = 0; c < CHUNK_COUNT; c++)
+    {
+      int offset = c * CHUNK_BYTES;
+      int len = min(CHUNK_BYTES, (int)sizeof(WeatherSnapshot) - offset);
+      send(FANOUT_CHUNK, location, c, seq, bytes + offset, len);
+    }
+    snapshotsSent++;
+  }
+
+  // A joining unit asked for the current snapshots (checked on the fetch task)
+  bool resendWanted() { return resendRequested.exchange(false); }
+
+  // A complete snapshot for location is waiting to be taken
+  bool ready(int location) const { return slots[location].state.load() == SLOT_READY; }
+
+  // Fetch side: copy out a complete snapshot for location if one is waiting.
+  // False if none, or if it failed its checksum (counted as dropped).
+  bool take(int location, WeatherData &out, time_t &fetchedAt)
+  {
+    Slot &slot = slots[location];
+    if (slot.state.load() != SLOT_READY)
+      return false;
+    bool ok = WeatherCache::unpack(slot.snapshot, out, fetchedAt);
+    if (!ok)
+      snapshotsDropped++;
+    slot.state.store(SLOT_EMPTY);
+    return ok;
+  }
+
+  void report()
+  {
+    Serial.printf("Fan-out: %s, %lu snapshots sent, %lu received, %lu dropped, %lu takeovers\n", roleName(),
+                  (unsigned long)snapshotsSent, (unsigned long)snapshotsReceived, (unsigned long)snapshotsDropped,
+                  (unsigned long)takeovers);
+  }
+
+private:
+  enum SlotState
+  {
+    SLOT_EMPTY,
+    SLOT_ASSEMBLING, // Owned by the network task
+    SLOT_READY       // Owned by the fetch task until taken
+  };
+
+  // One reassembly buffer per location, so back-to-back snapshots for
+  // different locations don't overwrite each other
+  struct Slot
+  {
+    WeatherSnapshot snapshot;
+    std::atomic<int> state{SLOT_EMPTY};
+    uint32_t node = 0;
+    uint32_t seq = 0;
+    uint32_t chunksSeen = 0; // Bit per chunk
+  };
+  static_assert(CHUNK_COUNT < 32, "Snapshot needs more chunks than the mask holds");
+
+  IPAddress group;
+  AsyncUDP udp;
+  bool listening = false;
+  void (*wake)() = nullptr;
+  uint32_t node = 0;
+  uint32_t sendSeq = 0;
+  WeatherSnapshot outgoing; // Only touched by share()
+  Slot slots[LOCATIONS];
+
+  std::atomic<FanoutRole> currentRole{FANOUT_LISTENING};
+  std::atomic<uint32_t> leader{0};
+  std::atomic<unsigned long> lastHeartbeat{0};
+  std::atomic<unsigned long> lastSnapshot{0};
+  std::atomic<unsigned long> followingSince{0};
+  std::atomic<bool> resendRequested{false};
+  unsigned long joinedAt = 0;
+
+  void send(FanoutPacket type, int location, int chunk, uint32_t seq, const uint8_t *body, int len)
+  {
+    uint8_t packet[sizeof(FanoutHeader) + CHUNK_BYTES];
+    FanoutHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.type = type;
+    header.location = location;
+    header.chunk = chunk;
+    header.chunkCount = CHUNK_COUNT;
+    header.node = node;
+    header.seq = seq;
+    memcpy(packet, &header, sizeof(header));
+    if (len > 0)
+      memcpy(packet + sizeof(header), body, len);
+    udp.writeTo(packet, sizeof(header) + len, group, PORT);
+  }
+
+  // Network task
+  void receive(const uint8_t *data, size_t length)
+  {
+    FanoutHeader header;
+    if (length < sizeof(header))
+      return;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION || header.node == node)
+      return;
+
+    switch (header.type)
+    {
+    case FANOUT_HEARTBEAT:
+      heardLeader(header.node);
+      break;
+    case FANOUT_HELLO:
+      if (currentRole == FANOUT_LEADER)
+      {
+        resendRequested = true;
+        if (wake != nullptr)
+          wake();
+      }
+      break;
+    case FANOUT_CHUNK:
+      heardLeader(header.node);
+      if (header.location < LOCATIONS && header.chunkCount == CHUNK_COUNT && header.chunk < CHUNK_COUNT)
+        addChunk(header, data + sizeof(header), length - sizeof(header));
+      break;
+    }
+  }
+
+  void heardLeader(uint32_t from)
+  {
+    // Two leaders: the higher id stands down
+    if (currentRole == FANOUT_LEADER && from > node)
+      return;
+    if (currentRole != FANOUT_FOLLOWER || leader != from)
+    {
+      Serial.printf("Fan-out: following %08lx\n", (unsigned long)from);
+      followingSince = millis();
+    }
+    leader = from;
+    currentRole = FANOUT_FOLLOWER;
+    lastHeartbeat = millis();
+  }
+
+  void addChunk(const FanoutHeader &header, const uint8_t *body, size_t len)
+  {
+    Slot &slot = slots[header.location];
+    int state = slot.state.load();
+    if (state == SLOT_READY)
+    {
+      // The last one hasn't been taken yet - a newer one follows soon enough
+      if (header.chunk == 0)
+        snapshotsDropped++;
+      return;
+    }
+    if (state == SLOT_EMPTY || slot.node != header.node || slot.seq != header.seq)
+    {
+      slot.state.store(SLOT_ASSEMBLING);
+      slot.node = header.node;
+      slot.seq = header.seq;
+      slot.chunksSeen = 0;
+    }
+
+    size_t offset = header.chunk * CHUNK_BYTES;
+    size_t expected = min((size_t)CHUNK_BYTES, sizeof(WeatherSnapshot) - offset);
+    if (len != expected)
+      return;
+    memcpy((uint8_t *)&slot.snapshot + offset, body, len);
+    slot.chunksSeen |= 1u << header.chunk;
+
+    if (slot.chunksSeen == (1u << CHUNK_COUNT) - 1)
+    {
+      snapshotsReceived++;
+      lastSnapshot = millis();
+      slot.state.store(SLOT_READY);
+      if (wake != nullptr)
+        wake();
+    }
+  }
+};
+
+#endif // SNAPSHOT_FANOUT_H
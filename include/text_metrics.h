@@ -0,0 +1,148 @@
+/*
+ * Text Metrics for Weather Display
+ *
+ * Advance widths of the built-in fonts (2, 4 and 7) copied into RAM once,
+ * so measuring a string is one table read per character instead of a
+ * walk through the font tables in flash. Strings from literals or static
+ * tables can also be memoised by address.
+ */
+
+#ifndef TEXT_METRICS_H
+#define TEXT_METRICS_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+class TextMetrics
+{
+public:
+  static const int MEMO_SIZE = 16;
+
+  // Counters for reading memo effectiveness
+  uint32_t memoHits = 0;
+  uint32_t memoMisses = 0;
+
+  explicit TextMetrics(TFT_eSPI *tft) : tft(tft) {}
+
+  // Measure every printable character of the tabled fonts - call once the
+  // display is set up
+  void begin()
+  {
+    uint8_t size = tft->textsize;
+    tft->setTextSize(1);
+    for (int f = 0; f < FONT_COUNT; f++)
+    {
+      for (int c = FIRST_CHAR; c <= LAST_CHAR; c++)
+      {
+        char one[2] = {(char)c, '\0'};
+        advance[f][c - FIRST_CHAR] = (uint8_t)tft->textWidth(one, FONTS[f]);
+      }
+    }
+    tft->setTextSize(size);
+    ready = true;
+  }
+
+  // Width of a string in the current font and text size
+  int16_t measure(const char *str) const { return measure(str, tft->textfont); }
+
+  // Width of a string in a given font at the current text size
+  int16_t measure(const char *str, uint8_t font) const
+  {
+    const uint8_t *widths = table(font);
+    if (widths == nullptr)
+      return tft->textWidth(str, font);
+
+    int32_t width = 0;
+    for (const char *p = str; *p != '\0'; p++)
+    {
+      uint8_t c = *p;
+      if (c < FIRST_CHAR || c > LAST_CHAR)
+        return tft->textWidth(str, font); // Let the library handle anything unusual
+      width += widths[c - FIRST_CHAR];
+    }
+    return (int16_t)(width * tft->textsize);
+  }
+
+  // Copy str into out (outLen bytes), cut short and ended with "..." if it
+  // is wider than maxWidth in the current font. Cuts fall between UTF-8
+  // characters, and spaces or commas left before the dots are dropped.
+  const char *elide(const char *str, int16_t maxWidth, char *out, size_t outLen) const
+  {
+    size_t len = strlen(str);
+    if (len < outLen && measure(str) <= maxWidth)
+    {
+      memcpy(out, str, len + 1);
+      return out;
+    }
+
+    int16_t dots = measure("...");
+    size_t keep = min(len, outLen - 4);
+    for (;;)
+    {
+      while (keep > 0 && ((uint8_t)str[keep] & 0xC0) == 0x80)
+        keep--;
+      while (keep > 0 && (str[keep - 1] == ' ' || str[keep - 1] == ','))
+        keep--;
+      memcpy(out, str, keep);
+      out[keep] = '\0';
+      if (keep == 0 || measure(out) + dots <= maxWidth)
+        break;
+      keep--;
+    }
+    memcpy(out + keep, "...", 4);
+    return out;
+  }
+
+  // measure() for strings whose contents never change at their address
+  // (literals, static name tables), remembered after the first call
+  int16_t measureStatic(const char *str) { return measureStatic(str, tft->textfont); }
+
+  int16_t measureStatic(const char *str, uint8_t font)
+  {
+    Memo &m = memo[((uintptr_t)str >> 2) % MEMO_SIZE];
+    if (m.str == str && m.font == font && m.size == tft->textsize)
+    {
+      memoHits++;
+      return m.width;
+    }
+    memoMisses++;
+    m.str = str;
+    m.font = font;
+    m.size = tft->textsize;
+    m.width = measure(str, font);
+    return m.width;
+  }
+
+private:
+  static const int FONT_COUNT = 3;
+  static constexpr uint8_t FONTS[FONT_COUNT] = {2, 4, 7};
+  static const int FIRST_CHAR = 32;
+  static const int LAST_CHAR = 126;
+
+  struct Memo
+  {
+    const char *str = nullptr;
+    uint8_t font = 0;
+    uint8_t size = 0;
+    int16_t width = 0;
+  };
+
+  TFT_eSPI *tft;
+  bool ready = false;
+  uint8_t advance[FONT_COUNT][LAST_CHAR - FIRST_CHAR + 1]; // At text size 1
+  Memo memo[MEMO_SIZE];
+
+  const uint8_t *table(uint8_t font) const
+  {
+    if (!ready)
+      return nullptr;
+    for (int f = 0; f < FONT_COUNT; f++)
+    {
+      if (FONTS[f] == font)
+        return advance[f];
+    }
+    return nullptr;
+  }
+};
+
+#endif // TEXT_METRICS_H
@@ -0,0 +1,129 @@
+/*
+ * Compile-Time Trig Tables for Weather Display
+ *
+ * A Q16.16 quarter-wave sine table built by the compiler, whole-degree
+ * sin/cos lookups on top of it, and precomputed ray offsets for the
+ * 12-ray sun icons so drawing one is integer adds only.
+ */
+
+#ifndef TRIG_TABLES_H
+#define TRIG_TABLES_H
+
+#include <array>
+#include "fixed_point.h"
+
+namespace trig_detail
+{
+  constexpr double RADIANS_PER_DEGREE = 3.14159265358979323846 / 180.0;
+
+  // Taylor series - converges well for the 0..pi/2 range the table needs
+  constexpr double sinTaylor(double x)
+  {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; n++)
+    {
+      term *= -x * x / ((2 * n) * (2 * n + 1));
+      sum += term;
+    }
+    return sum;
+  }
+
+  constexpr std::array<fixed_t, 91> buildQuarterSine()
+  {
+    std::array<fixed_t, 91> table{};
+    for (int deg = 0; deg <= 90; deg++)
+    {
+      table[deg] = toFixed(sinTaylor(deg * RADIANS_PER_DEGREE));
+    }
+    return table;
+  }
+}
+
+// sin(0..90 degrees) in Q16.16
+inline constexpr std::array<fixed_t, 91> QUARTER_SINE = trig_detail::buildQuarterSine();
+
+constexpr fixed_t sinDeg(int deg)
+{
+  deg %= 360;
+  if (deg < 0)
+    deg += 360;
+  if (deg <= 90)
+    return QUARTER_SINE[deg];
+  if (deg <= 180)
+    return QUARTER_SINE[180 - deg];
+  if (deg <= 270)
+    return -QUARTER_SINE[deg - 180];
+  return -QUARTER_SINE[360 - deg];
+}
+
+constexpr fixed_t cosDeg(int deg)
+{
+  return sinDeg(deg + 90);
+}
+
+// Sun icon rays - ray i is a triangle from tip[i] to base[i] and base[i + 1]
+constexpr int SUN_RAY_COUNT = 12;
+constexpr int SUN_RAY_STEP = 360 / SUN_RAY_COUNT;
+
+struct SunRayTemplate
+{
+  fixed_t tipX[SUN_RAY_COUNT];
+  fixed_t tipY[SUN_RAY_COUNT];
+  fixed_t baseX[SUN_RAY_COUNT];
+  fixed_t baseY[SUN_RAY_COUNT];
+};
+
+constexpr SunRayTemplate makeSunRays(fixed_t outerR, fixed_t innerR)
+{
+  SunRayTemplate rays{};
+  for (int i = 0; i < SUN_RAY_COUNT; i++)
+  {
+    int angle = i * SUN_RAY_STEP;
+    int mid = angle + SUN_RAY_STEP / 2;
+    rays.tipX[i] = fixedMul(cosDeg(mid), outerR);
+    rays.tipY[i] = fixedMul(sinDeg(mid), outerR);
+    rays.baseX[i] = fixedMul(cosDeg(angle), innerR);
+    rays.baseY[i] = fixedMul(sinDeg(angle), innerR);
+  }
+  return rays;
+}
+
+enum SunStyle
+{
+  SUN_CLEAR,        // Full sun - rays from 0.55r to 0.75r
+  SUN_BEHIND_CLOUD  // Small sun behind a cloud - rays from 0.35r to 0.48r
+};
+
+template <int Size>
+struct SunRays
+{
+  static constexpr int r = Size / 2;
+  static constexpr SunRayTemplate clear = makeSunRays(r * toFixed(0.75), r * toFixed(0.55));
+  static constexpr SunRayTemplate behindCloud = makeSunRays(r * toFixed(0.48), r * toFixed(0.35));
+};
+
+// Ray offsets for an icon size - precomputed for the sizes the screens use,
+// built on the fly for anything else
+inline const SunRayTemplate &sunRaysFor(int size, SunStyle style)
+{
+  switch (size)
+  {
+  case 35:
+    return style == SUN_CLEAR ? SunRays<35>::clear : SunRays<35>::behindCloud;
+  case 40:
+    return style == SUN_CLEAR ? SunRays<40>::clear : SunRays<40>::behindCloud;
+  case 55:
+    return style == SUN_CLEAR ? SunRays<55>::clear : SunRays<55>::behindCloud;
+  }
+
+  static SunRayTemplate custom;
+  int r = size / 2;
+  if (style == SUN_CLEAR)
+    custom = makeSunRays(r * toFixed(0.75), r * toFixed(0.55));
+  else
+    custom = makeSunRays(r * toFixed(0.48), r * toFixed(0.35));
+  return custom;
+}
+
+#endif // TRIG_TABLES_H
@@ -9,6 +9,37 @@
 
 #include <Arduino.h>
 #include <time.h>
+#include <type_traits>
+
+// Fixed capacities for text copied out of the One Call response
+#define CONDITION_LEN 32 // e.g. "Light intensity shower rain"
+#define SUMMARY_LEN 128  // OWM daily summaries are a sentence or two
+
+// One Call response sections, refreshed on independent cadences
+enum WeatherSection
+{
+  SECTION_CURRENT,
+  SECTION_MINUTELY,
+  SECTION_HOURLY,
+  SECTION_DAILY,
+  SECTION_COUNT
+};
+#define SECTION_BIT(s) (1 << (s))
+#define SECTIONS_ALL ((1 << SECTION_COUNT) - 1)
+
+// Screens, in navigation order
+enum Screen
+{
+  SCREEN_HOURLY,
+  SCREEN_HOURLY2,
+  SCREEN_CONDITIONS,
+  SCREEN_DAILY,
+  SCREEN_SETTINGS,
+  SCREEN_ABOUT,
+  SCREEN_DEMO,
+  SCREEN_DEMO2,
+  SCREEN_DEMO3
+};
 
 // Hourly forecast data
 struct HourlyData
@@ -24,9 +55,9 @@ struct DailyData
   float tempMin;
   float tempMax;
   int weatherCode;
-  String dayName;
-  int pop;        // Probability of precipitation (0-100%)
-  String summary; // Human-readable weather summary
+  const char *dayName;       // Interned short day name (static table, never freed)
+  int pop;                   // Probability of precipitation (0-100%)
+  char summary[SUMMARY_LEN]; // Human-readable weather summary
 };
 
 // Main weather data structure
@@ -37,9 +68,9 @@ struct WeatherData
   int humidity;
   float windSpeed;
   int windDeg;
-  String windDir;
+  const char *windDir; // Interned compass point from degToCompass()
   int weatherCode;
-  String condition;
+  char condition[CONDITION_LEN];
   float minutelyRain[60];
   bool hasMinutelyData;
   bool dataValid;
@@ -59,6 +90,11 @@ struct WeatherData
   time_t moonrise;
   time_t moonset;
   float moonPhase; // 0-1
+  // When each section was last refreshed (epoch seconds, 0 = never)
+  time_t sectionUpdated[SECTION_COUNT];
 };
 
+// Snapshots are copied with memcpy and stored raw, so no heap-owning members
+static_assert(std::is_trivially_copyable<WeatherData>::value, "WeatherData must stay trivially copyable");
+
 #endif // TYPES_H
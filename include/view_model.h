@@ -0,0 +1,146 @@
+/*
+ * View Model for Weather Display
+ *
+ * Everything the screens derive from a weather snapshot that only
+ * changes when new data arrives - hour labels, daylight flags, colours,
+ * formatted numbers, the wrapped summary and the sunrise/sunset times.
+ * Built once per snapshot on the render side, so redraws only read it.
+ */
+
+#ifndef VIEW_MODEL_H
+#define VIEW_MODEL_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <time.h>
+#include "types.h"
+#include "helpers.h"
+#include "text_metrics.h"
+
+// Layout the summary is wrapped for (Hourly screen, right of the icon)
+#define SUMMARY_FONT 2
+#define SUMMARY_WIDTH 150
+#define SUMMARY_MAX_LINES 8
+
+struct HourView
+{
+  char label[6]; // "12am"
+  char temp[8];  // Rounded, e.g. "23"
+  uint16_t tempColor;
+  bool daytime; // Between the sunrise and sunset hours
+};
+
+struct DayView
+{
+  char temps[16]; // "31 / 22"
+  uint16_t tempColor; // Colour of the high
+};
+
+class ViewModel
+{
+public:
+  HourView hourly[24];
+  DayView daily[8];
+  char temp[8]; // Current temperature, rounded
+  uint16_t tempColor;
+  uint16_t dewPointColor;
+  char uv[24]; // "7.2 High"
+  uint16_t uvColor;
+
+  // Summary split into lines: each starts at summary + lineStart[i] and is
+  // NUL-terminated in place
+  char summary[SUMMARY_LEN];
+  uint8_t lineStart[SUMMARY_MAX_LINES];
+  int lineCount = 0;
+
+  char sunriseText[10]; // "06:45 AM"
+  char sunsetText[10];
+
+  // Rebuild from a snapshot - text supplies the font metrics for wrapping
+  void build(const WeatherData &data, const TextMetrics &text)
+  {
+    snapshot = &data;
+
+    // Hour of sunrise and sunset for the daylight flags
+    struct tm sunriseTm, sunsetTm;
+    localtime_r(&data.sunrise, &sunriseTm);
+    localtime_r(&data.sunset, &sunsetTm);
+
+    for (int i = 0; i < data.hourlyCount && i < 24; i++)
+    {
+      HourView &h = hourly[i];
+      int hour = data.hourly[i].hour;
+      int displayH = hour % 12 == 0 ? 12 : hour % 12;
+      snprintf(h.label, sizeof(h.label), "%d%s", displayH, hour < 12 ? "am" : "pm");
+      snprintf(h.temp, sizeof(h.temp), "%.0f", data.hourly[i].temperature);
+      h.tempColor = getTempColor(data.hourly[i].temperature);
+      h.daytime = hour >= sunriseTm.tm_hour && hour <= sunsetTm.tm_hour;
+    }
+
+    for (int i = 0; i < data.dailyCount && i < 8; i++)
+    {
+      DayView &d = daily[i];
+      snprintf(d.temps, sizeof(d.temps), "%d / %d", (int)data.daily[i].tempMax, (int)data.daily[i].tempMin);
+      d.tempColor = getTempColor(data.daily[i].tempMax);
+    }
+
+    snprintf(temp, sizeof(temp), "%.0f", data.temperature);
+    tempColor = getTempColor(data.temperature);
+    dewPointColor = getTempColor(data.dewPoint);
+    snprintf(uv, sizeof(uv), "%.1f %s", data.uvi, getUVDescription(data.uvi));
+    uvColor = getUVColor(data.uvi);
+
+    wrapSummary(data.dailyCount > 0 ? data.daily[0].summary : "", text);
+
+    strftime(sunriseText, sizeof(sunriseText), "%I:%M %p", localtime_r(&data.sunrise, &sunriseTm));
+    strftime(sunsetText, sizeof(sunsetText), "%I:%M %p", localtime_r(&data.sunset, &sunsetTm));
+    sunPivot = data.sunrise + (data.sunset - data.sunrise) / 2;
+  }
+
+  // The sunrise or sunset closest to now - they swap over halfway between
+  bool nextSunIsRise(time_t now) const
+  {
+    return (now < sunPivot) == (snapshot->sunrise < snapshot->sunset);
+  }
+
+private:
+  const WeatherData *snapshot = nullptr;
+  time_t sunPivot = 0;
+
+  // Greedy word wrap to SUMMARY_WIDTH. The space at each break becomes the
+  // NUL ending the line; a word wider than the box gets a line to itself.
+  void wrapSummary(const char *str, const TextMetrics &text)
+  {
+    strlcpy(summary, str, sizeof(summary));
+    lineCount = 0;
+    if (summary[0] == '\0')
+      return;
+
+    lineStart[lineCount++] = 0;
+    int lineBegin = 0;
+    int lastBreak = -1; // Space after the last word on the current line
+    for (int i = 0;; i++)
+    {
+      char c = summary[i];
+      if (c != ' ' && c != '\0')
+        continue;
+
+      // Would the line still fit with this word on the end?
+      summary[i] = '\0';
+      bool fits = text.measure(summary + lineBegin, SUMMARY_FONT) <= SUMMARY_WIDTH;
+      summary[i] = c;
+
+      if (!fits && lastBreak >= lineBegin && lineCount < SUMMARY_MAX_LINES)
+      {
+        summary[lastBreak] = '\0';
+        lineBegin = lastBreak + 1;
+        lineStart[lineCount++] = lineBegin;
+      }
+      if (c == '\0')
+        break;
+      lastBreak = i;
+    }
+  }
+};
+
+#endif // VIEW_MODEL_H
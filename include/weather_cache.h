@@ -0,0 +1,159 @@
+/*
+ * Weather Snapshot Cache for Weather Display
+ *
+ * Keeps the last good WeatherData in RTC memory (survives resets and deep
+ * sleep) and in NVS (survives power loss), each with a version and CRC32,
+ * so boot can draw the last forecast before WiFi is even up.
+ */
+
+#ifndef WEATHER_CACHE_H
+#define WEATHER_CACHE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <rom/crc.h>
+#include "types.h"
+#include "helpers.h"
+
+// Stored form of a snapshot. The interned name pointers in WeatherData are
+// only valid for the firmware that wrote them, so the day indices travel
+// alongside and the pointers are rebuilt on load.
+struct WeatherSnapshot
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size; // sizeof(WeatherData) when written
+  time_t savedAt;
+  uint8_t dayIndex[8]; // tm_wday of each daily entry
+  WeatherData data;
+  uint32_t crc; // CRC32 of everything above
+};
+
+class WeatherCache
+{
+public:
+  static const uint32_t MAGIC = 0x57534E50; // "WSNP"
+  static const uint16_t VERSION = 1;         // Bump when WeatherData's meaning changes
+  static const time_t NVS_SAVE_INTERVAL = 1800; // Limit flash writes to one per 30 min
+
+  explicit WeatherCache(WeatherSnapshot *rtc) : rtc(rtc) {}
+
+  // Store a snapshot - RTC every time, NVS at most every NVS_SAVE_INTERVAL
+  void save(const WeatherData &data, time_t now)
+  {
+    pack(data, now, *rtc);
+
+    if (nvsSavedAt != 0 && now - nvsSavedAt < NVS_SAVE_INTERVAL)
+      return;
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false))
+    {
+      Serial.println("Snapshot cache: NVS unavailable");
+      return;
+    }
+    if (prefs.putBytes(NVS_KEY, rtc, sizeof(WeatherSnapshot)) == sizeof(WeatherSnapshot))
+      nvsSavedAt = now;
+    else
+      Serial.println("Snapshot cache: NVS write failed");
+    prefs.end();
+  }
+
+  // Restore the newest valid snapshot, RTC first. False if neither is usable.
+  bool load(WeatherData &out, time_t &savedAt)
+  {
+    if (unpack(*rtc, out, savedAt))
+    {
+      Serial.println("Snapshot cache: restored from RTC memory");
+      return true;
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true))
+      return false;
+    bool ok = prefs.getBytesLength(NVS_KEY) == sizeof(WeatherSnapshot) &&
+              prefs.getBytes(NVS_KEY, rtc, sizeof(WeatherSnapshot)) == sizeof(WeatherSnapshot) &&
+              unpack(*rtc, out, savedAt);
+    prefs.end();
+    if (!ok)
+      return false;
+
+    Serial.println("Snapshot cache: restored from NVS");
+    nvsSavedAt = rtc->savedAt;
+    return true;
+  }
+
+  // Stored form of a WeatherData, stamped and checksummed - also what
+  // goes over the air between units running the same firmware
+  static void pack(const WeatherData &data, time_t savedAt, WeatherSnapshot &s)
+  {
+    s.magic = MAGIC;
+    s.version = VERSION;
+    s.size = sizeof(WeatherData);
+    s.savedAt = savedAt;
+    for (int i = 0; i < 8; i++)
+    {
+      s.dayIndex[i] = dayIndexOf(data.daily[i].dayName);
+    }
+    s.data = data;
+    s.crc = checksum(s);
+  }
+
+  // Rebuild a WeatherData from a stored snapshot. False (and out untouched)
+  // if the snapshot is damaged or from another layout.
+  static bool unpack(const WeatherSnapshot &s, WeatherData &out, time_t &savedAt)
+  {
+    if (!valid(s))
+      return false;
+    restore(s, out, savedAt);
+    return true;
+  }
+
+private:
+  static constexpr const char *NVS_NAMESPACE = "weather";
+  static constexpr const char *NVS_KEY = "snapshot";
+
+  WeatherSnapshot *rtc; // Lives in RTC slow memory, defined in main.cpp
+  time_t nvsSavedAt = 0;
+
+  static uint32_t checksum(const WeatherSnapshot &s)
+  {
+    return crc32_le(0, (const uint8_t *)&s, offsetof(WeatherSnapshot, crc));
+  }
+
+  // The CRC only catches damage - fan-out snapshots come off the LAN, so
+  // anything that indexes an array is bounds-checked as well
+  static bool valid(const WeatherSnapshot &s)
+  {
+    const int maxHourly = sizeof(s.data.hourly) / sizeof(s.data.hourly[0]);
+    const int maxDaily = sizeof(s.data.daily) / sizeof(s.data.daily[0]);
+    return s.magic == MAGIC && s.version == VERSION && s.size == sizeof(WeatherData) &&
+           s.crc == checksum(s) && s.data.dataValid && s.data.hourlyCount >= 0 &&
+           s.data.hourlyCount <= maxHourly && s.data.dailyCount >= 0 && s.data.dailyCount <= maxDaily;
+  }
+
+  static uint8_t dayIndexOf(const char *dayName)
+  {
+    for (int d = 0; d < 7; d++)
+    {
+      if (dayName == shortDayName(d))
+        return d;
+    }
+    return 0;
+  }
+
+  static void restore(const WeatherSnapshot &s, WeatherData &out, time_t &savedAt)
+  {
+    out = s.data;
+    out.windDir = degToCompass(out.windDeg);
+    out.condition[sizeof(out.condition) - 1] = '\0';
+    for (int i = 0; i < 8; i++)
+    {
+      out.daily[i].dayName = shortDayName(s.dayIndex[i]);
+      out.daily[i].summary[sizeof(out.daily[i].summary) - 1] = '\0';
+    }
+    savedAt = s.savedAt;
+  }
+};
+
+#endif // WEATHER_CACHE_H
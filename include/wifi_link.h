@@ -0,0 +1,343 @@
+/*
+ * WiFi Link State Machine for Weather Display
+ *
+ * Non-blocking connection management driven by WiFi.onEvent():
+ * IDLE -> ASSOCIATING -> DHCP -> NTP -> ONLINE, with BACKOFF (exponential,
+ * jittered) after failures. The access point (BSSID + channel) of the last
+ * successful join is remembered in RTC memory and NVS so rejoins skip the
+ * channel scan; a failed fast attempt falls straight back to a normal
+ * scanning join. Addresses always come from DHCP (or WIFI_STATIC_IP), so
+ * the lease is renewed like any other client's and never outlives it.
+ */
+
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Preferences.h>
+#include <rom/crc.h>
+#include <atomic>
+#include <limits.h>
+
+// Parameters of the last successful join
+struct WiFiLinkRecord
+{
+  uint32_t magic;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint32_t crc; // CRC32 of everything above
+};
+
+enum LinkState
+{
+  LINK_IDLE,
+  LINK_ASSOCIATING,
+  LINK_DHCP,
+  LINK_NTP,
+  LINK_ONLINE,
+  LINK_BACKOFF
+};
+
+class WiFiLink
+{
+public:
+  static const uint32_t MAGIC = 0x5746414D;         // Bumped when the record layout changes
+  static const unsigned long FAST_TIMEOUT_MS = 3000; // Direct join normally takes a few hundred ms
+  static const unsigned long FULL_TIMEOUT_MS = 15000;
+  static const unsigned long DHCP_TIMEOUT_MS = 10000;
+  static const unsigned long NTP_TIMEOUT_MS = 10000; // Go online without a clock after this
+  static const unsigned long BACKOFF_MIN_MS = 1000;
+  static const unsigned long BACKOFF_MAX_MS = 300000;
+  static const unsigned long NO_DEADLINE = ULONG_MAX;
+
+  // How the last join went, for logging
+  bool lastWasFast = false;
+  unsigned long lastJoinMs = 0;
+  unsigned long connectedAt = 0; // millis() when the link came up, 0 once reported
+  uint32_t joins = 0;            // Successful joins since boot - all but the first are reconnects
+
+  WiFiLink(const char *ssid, const char *password, WiFiLinkRecord *rtc)
+      : ssid(ssid), password(password), rtc(rtc) {}
+
+  // wake: called from the WiFi event task so the owner can run poll() promptly.
+  // gotIp: called from poll() when an address is assigned (start SNTP etc).
+  // clockValid: whether the NTP state can be skipped.
+  void setHooks(void (*wake)(), void (*gotIp)(), bool (*clockValid)())
+  {
+    this->wake = wake;
+    this->gotIp = gotIp;
+    this->clockValid = clockValid;
+  }
+
+  // Start connecting - returns immediately, progress happens in poll()
+  void begin()
+  {
+    WiFi.mode(WIFI_STA);
+    WiFi.persistent(false);       // We keep our own record - skip the SDK's flash write per join
+    WiFi.setAutoReconnect(false); // Retries are ours, with backoff
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t)
+                 { onEvent(event); });
+    startAttempt();
+  }
+
+  // Advance the state machine. Returns true on the transition to ONLINE.
+  bool poll()
+  {
+    uint32_t events = pending.exchange(0);
+    unsigned long now = millis();
+    bool cameOnline = false;
+
+    switch (current)
+    {
+    case LINK_IDLE:
+      break;
+
+    case LINK_ASSOCIATING:
+    case LINK_DHCP:
+      if (events & EV_GOT_IP)
+      {
+        joined(now);
+        if (clockValid != nullptr && clockValid())
+          cameOnline = enter(LINK_ONLINE, NO_DEADLINE);
+        else
+          enter(LINK_NTP, NTP_TIMEOUT_MS);
+      }
+      else if ((events & EV_CONNECTED) && current == LINK_ASSOCIATING)
+      {
+        enter(LINK_DHCP, DHCP_TIMEOUT_MS);
+      }
+      else if (((events & EV_DISCONNECTED) && current == LINK_DHCP) || expired(now))
+      {
+        // Disconnects while associating are the SDK retrying - only the timeout counts
+        attemptFailed();
+      }
+      break;
+
+    case LINK_NTP:
+      if (events & EV_DISCONNECTED)
+        linkLost();
+      else if ((clockValid != nullptr && clockValid()) || expired(now))
+        cameOnline = enter(LINK_ONLINE, NO_DEADLINE);
+      break;
+
+    case LINK_ONLINE:
+      if (events & EV_DISCONNECTED)
+        linkLost();
+      break;
+
+    case LINK_BACKOFF:
+      if (expired(now))
+        startAttempt();
+      break;
+    }
+    return cameOnline;
+  }
+
+  LinkState state() const { return current; }
+  bool hasIp() const { return current == LINK_NTP || current == LINK_ONLINE; }
+
+  const char *stateName() const
+  {
+    static const char *const names[] = {"idle", "associating", "dhcp", "ntp", "online", "backoff"};
+    return names[current];
+  }
+
+  // Time until poll() has something to do without an event, NO_DEADLINE if none
+  unsigned long msUntilDeadline() const
+  {
+    if (deadline == NO_DEADLINE)
+      return NO_DEADLINE;
+    long left = (long)(deadline - millis());
+    return left > 0 ? (unsigned long)left : 0;
+  }
+
+  // Drop the remembered AP (e.g. after credentials change)
+  void forget()
+  {
+    rtc->magic = 0;
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false))
+    {
+      prefs.remove(NVS_KEY);
+      prefs.end();
+    }
+  }
+
+private:
+  static constexpr const char *NVS_NAMESPACE = "wifi";
+  static constexpr const char *NVS_KEY = "link";
+
+  enum : uint32_t
+  {
+    EV_CONNECTED = 1 << 0,
+    EV_GOT_IP = 1 << 1,
+    EV_DISCONNECTED = 1 << 2
+  };
+
+  const char *ssid;
+  const char *password;
+  WiFiLinkRecord *rtc; // Lives in RTC slow memory, defined in main.cpp
+
+  void (*wake)() = nullptr;
+  void (*gotIp)() = nullptr;
+  bool (*clockValid)() = nullptr;
+
+  // Only poll() changes the state; the event task just posts bits
+  std::atomic<LinkState> current{LINK_IDLE};
+  std::atomic<uint32_t> pending{0};
+  unsigned long deadline = NO_DEADLINE;
+  unsigned long attemptStart = 0;
+  bool attemptFast = false;
+  int failures = 0; // Consecutive failed full attempts
+
+  // Runs on the WiFi event task
+  void onEvent(arduino_event_id_t event)
+  {
+    switch (event)
+    {
+    case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+      pending |= EV_CONNECTED;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      pending |= EV_GOT_IP;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      pending |= EV_DISCONNECTED;
+      break;
+    default:
+      return;
+    }
+    if (wake != nullptr)
+      wake();
+  }
+
+  bool enter(LinkState next, unsigned long timeoutMs)
+  {
+    current = next;
+    deadline = timeoutMs == NO_DEADLINE ? NO_DEADLINE : millis() + timeoutMs;
+    Serial.printf("WiFi: %s\n", stateName());
+    return next == LINK_ONLINE;
+  }
+
+  bool expired(unsigned long now) const
+  {
+    return deadline != NO_DEADLINE && (long)(now - deadline) >= 0;
+  }
+
+  void startAttempt()
+  {
+    attemptStart = millis();
+    attemptFast = loadRecord();
+
+    // Static settings from credentials.h, otherwise DHCP
+#ifdef WIFI_STATIC_IP
+    WiFi.config(IPAddress(WIFI_STATIC_IP), IPAddress(WIFI_GATEWAY), IPAddress(WIFI_SUBNET), IPAddress(WIFI_DNS));
+#else
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+#endif
+    if (attemptFast)
+      WiFi.begin(ssid, password, rtc->channel, rtc->bssid);
+    else
+      WiFi.begin(ssid, password);
+    enter(LINK_ASSOCIATING, attemptFast ? FAST_TIMEOUT_MS : FULL_TIMEOUT_MS);
+  }
+
+  void attemptFailed()
+  {
+    WiFi.disconnect();
+    if (attemptFast)
+    {
+      // AP moved channel or was replaced - scan right away
+      Serial.println("WiFi fast join failed - scanning");
+      forget();
+      startAttempt();
+      return;
+    }
+    failures++;
+    backoff();
+  }
+
+  void linkLost()
+  {
+    Serial.println("WiFi link lost");
+    WiFi.disconnect();
+    failures = 0;
+    backoff();
+  }
+
+  // Exponential backoff with +-25% jitter, so a room full of units that lost
+  // the same AP don't all retry in lockstep
+  void backoff()
+  {
+    unsigned long delayMs = BACKOFF_MIN_MS << min(failures, 9);
+    if (delayMs > BACKOFF_MAX_MS)
+      delayMs = BACKOFF_MAX_MS;
+    delayMs = delayMs * 3 / 4 + esp_random() % (delayMs / 2 + 1);
+    Serial.printf("WiFi retry in %lu ms\n", delayMs);
+    enter(LINK_BACKOFF, delayMs);
+  }
+
+  void joined(unsigned long now)
+  {
+    lastWasFast = attemptFast;
+    lastJoinMs = now - attemptStart;
+    connectedAt = now;
+    failures = 0;
+    joins++;
+    if (!attemptFast)
+      saveRecord();
+    Serial.printf("WiFi joined in %lu ms (%s, channel %d, IP %s)\n", lastJoinMs,
+                  attemptFast ? "fast" : "scan", WiFi.channel(), WiFi.localIP().toString().c_str());
+    if (gotIp != nullptr)
+      gotIp();
+  }
+
+  static uint32_t checksum(const WiFiLinkRecord &r)
+  {
+    return crc32_le(0, (const uint8_t *)&r, offsetof(WiFiLinkRecord, crc));
+  }
+
+  static bool valid(const WiFiLinkRecord &r)
+  {
+    return r.magic == MAGIC && r.crc == checksum(r) && r.channel >= 1 && r.channel <= 14;
+  }
+
+  // RTC copy first; NVS covers power loss
+  bool loadRecord()
+  {
+    if (valid(*rtc))
+      return true;
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true))
+      return false;
+    bool ok = prefs.getBytes(NVS_KEY, rtc, sizeof(WiFiLinkRecord)) == sizeof(WiFiLinkRecord) && valid(*rtc);
+    prefs.end();
+    return ok;
+  }
+
+  void saveRecord()
+  {
+    WiFiLinkRecord fresh = {};
+    fresh.magic = MAGIC;
+    memcpy(fresh.bssid, WiFi.BSSID(), sizeof(fresh.bssid));
+    fresh.channel = WiFi.channel();
+    fresh.crc = checksum(fresh);
+
+    // Only touch flash when something actually changed
+    if (memcmp(&fresh, rtc, sizeof(fresh)) == 0)
+      return;
+    *rtc = fresh;
+
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false))
+    {
+      prefs.putBytes(NVS_KEY, rtc, sizeof(WiFiLinkRecord));
+      prefs.end();
+    }
+  }
+};
+
+#endif // WIFI_LINK_H
@@ -2,7 +2,7 @@
  * Weather Display - Horizontal Landscape Design
  * Using OpenWeatherMap One Call API 3.0
  *
- * Location: Aroona, QLD
+ * Locations: listed in LOCATIONS below
  *
  * Wiring:
  * SCL  -> GPIO18
@@ -21,16 +21,55 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include <TFT_eSPI.h>
 #include <time.h>
+#include <atomic>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
 #include "credentials.h"
 #include "helpers.h"
+#include "palette.h"
+#include "dirty_region.h"
+#include "frame_diff.h"
+#include "dma_push.h"
+#include "icon_cache.h"
+#include "trig_tables.h"
+#include "https_connection.h"
+#include "duty_cycle.h"
+#include "scheduler.h"
+#include "weather_cache.h"
+#include "wifi_link.h"
+#include "perf_stats.h"
+#include "counting_allocator.h"
+#include "text_metrics.h"
+#include "view_model.h"
+#include "locations.h"
+#include "relay_snapshot.h"
+#include "history_ring.h"
+#include "screens.h"
+#include "frame_cache.h"
+#include "button_input.h"
+#ifdef SNAPSHOT_FANOUT
+#include "snapshot_fanout.h"
+#endif
+#ifdef ASSET_PACK
+#include "asset_store.h"
+#endif
+#ifdef METRICS_HTTP
+#include "metrics_server.h"
+#endif
+
+// Locations, in the order LEFT/RIGHT step through them (API key in credentials.h)
+const Location LOCATIONS[] = {
+    {"Caloundra, QLD", "-26.7984", "153.1394"},
+};
+const int LOCATION_COUNT = sizeof(LOCATIONS) / sizeof(LOCATIONS[0]);
+static_assert(LOCATION_COUNT <= FetchRotation::MAX_LOCATIONS, "Too many locations for the fetch rotation");
 
-// OpenWeatherMap settings (API key in credentials.h)
-const char *LATITUDE = "-26.7984";
-const char *LONGITUDE = "153.1394";
+// One Call calls per UTC day on the free tier
+const uint32_t OWM_DAILY_QUOTA = 1000;
 
 // Button pins
 #define BTN_LEFT 13
@@ -39,44 +78,85 @@ const char *LONGITUDE = "153.1394";
 
 // Update interval - 5 minutes
 const unsigned long UPDATE_INTERVAL = 300000;
-unsigned long lastUpdate = 0;
 
-// Button debounce
-unsigned long lastButtonPress = 0;
-const unsigned long DEBOUNCE_DELAY = 200;
+// Refresh cadence per One Call section, in seconds. Sections that aren't due
+// are left out of the request with exclude= and carried over from the last fetch.
+const unsigned long SECTION_INTERVAL[SECTION_COUNT] = {
+    300,   // current
+    300,   // minutely
+    1800,  // hourly
+    10800, // daily
+};
+const char *const SECTION_NAMES[SECTION_COUNT] = {"current", "minutely", "hourly", "daily"};
+
+// Button edges captured by GPIO interrupts, debounced by the loop
+const uint8_t BUTTON_PINS[] = {BTN_LEFT, BTN_RIGHT, BTN_SELECT};
+const int BUTTON_COUNT = sizeof(BUTTON_PINS) / sizeof(BUTTON_PINS[0]);
+EdgeRing<32> buttonEdges;
+DebouncedButton buttons[BUTTON_COUNT]; // In BUTTON_PINS order
+const unsigned long REPEAT_INTERVAL = 200; // Held LEFT/RIGHT steps again this often
+
+// Input-to-photon latency: edge of the press being answered until its frame
+// has been pushed to the panel
+LatencySamples inputLatency;
+uint32_t inputAt = 0;
+bool inputPending = false;
 
 // TFT Display and sprite for flicker-free rendering
+const int FRAME_WIDTH = 320;
+const int FRAME_HEIGHT = 240;
 TFT_eSPI tft = TFT_eSPI();
 TFT_eSprite sprite = TFT_eSprite(&tft);
-
-// Screen states
-enum Screen
-{
-  SCREEN_HOURLY,
-  SCREEN_HOURLY2,
-  SCREEN_CONDITIONS,
-  SCREEN_DAILY,
-  SCREEN_SETTINGS,
-  SCREEN_ABOUT,
-  SCREEN_DEMO,
-  SCREEN_DEMO2,
-  SCREEN_DEMO3
-};
+DirtyRegion dirty(FRAME_WIDTH, FRAME_HEIGHT); // Frame areas changed since the last push
+FrameDiff frameDiff(FRAME_WIDTH, FRAME_HEIGHT); // Tile hashes of the last pushed frame (full-frame modes)
+
+#ifdef BANDED_RENDER
+// Banded output: the sprite is one 16-bit band, and every frame is drawn
+// once per band with the viewport shifted, so drawing code keeps using
+// full-screen coordinates. 15 KB instead of the 76.8 KB 8-bit frame.
+const int BAND_HEIGHT = 24;
+int bandTop = 0; // Screen row of the band being drawn
+#endif
+
+#if defined(PALETTE_FRAME) && defined(BANDED_RENDER)
+#error "PALETTE_FRAME and BANDED_RENDER are alternative frame modes - pick one"
+#endif
+
+// Render output - DMA band pushes when the buffers could be allocated
+DmaBandPusher dmaPusher;
+bool dmaOutput = true;
+unsigned long lastPushMicros = 0; // Duration of the most recent pushFrame()
+
+// Timing probes and memory counters (Settings screen + JSON lines on Serial)
+PerfStats perf;
+const unsigned long PERF_REFRESH_INTERVAL = 1000; // Live summary on the Settings screen
+
+// Screen states (enum Screen in types.h)
 Screen currentScreen = SCREEN_HOURLY; // Start on hourly forecast
 
 // Auto page switch
 const unsigned long PAGE_SWITCH_INTERVAL = 3000; // 3 seconds
-unsigned long lastPageSwitch = 0;
 bool autoSwitch = false; // Enable auto switching
 
 // Colon flash timer
-unsigned long lastColonUpdate = 0;
 const unsigned long COLON_FLASH_INTERVAL = 500;
 bool colonVisible = true;
 
+// Deadline scheduler driving loop() - jobs registered in setup()
+Scheduler scheduler;
+int pageJob = Scheduler::NO_JOB;
+int colonJob = Scheduler::NO_JOB;
+const unsigned long WIFI_JOIN_TIMEOUT = WiFiLink::FAST_TIMEOUT_MS + WiFiLink::FULL_TIMEOUT_MS; // Boot screen wait
+const unsigned long STATS_INTERVAL = 60000;
+const unsigned long HELD_BUTTON_POLL = 20; // Poll rate while a button is down or settling (long press, repeat)
+TaskHandle_t loopTaskHandle = nullptr;     // Woken by button interrupts and new weather
+
 // Display power state
 bool displayOn = true;
 
+// Busy/idle/sleep accounting for both display modes
+DutyCycleMeter dutyCycle;
+
 // Animation control - when true, display functions skip the final pushSprite
 bool skipPush = false;
 
@@ -84,37 +164,94 @@ bool skipPush = false;
 // Screen modes: weather screens vs settings screens
 bool settingsMode = false;                 // false = weather (Current, Hourly, Daily), true = settings (Settings, Demo)
 const unsigned long LONG_PRESS_TIME = 800; // Long press threshold in ms
-unsigned long selectPressStart = 0;
-bool selectHeld = false;
+uint32_t selectPressAt = 0;     // Press edge, micros
 bool longPressHandled = false; // Prevents short-click firing after long-press
-
-// Color palette - elegant dark mode
-#define COLOR_BG 0x0000         // Pure black
-#define COLOR_TEXT 0xD69A       // Soft white (toned down)
-#define COLOR_SUBTLE 0x8410     // Grey for secondary text
-#define COLOR_RAIN_BG 0x0A1F    // Very dark blue for rain bars
-#define COLOR_SUN 0xFE60        // Warm yellow
-#define COLOR_CLOUD 0x8C71      // Light grey (highlight) - toned down
-#define COLOR_CLOUD_MID 0x6B6D  // Medium grey
-#define COLOR_CLOUD_DARK 0x4228 // Dark grey (shadow)
-#define COLOR_RAIN TFT_BLUE     // Pure blue for rain/humidity
-#define COLOR_BOLT 0xFFE0       // Yellow for lightning
-#define COLOR_SNOW 0xBDF7       // Light blue-white for snow
-#define COLOR_SUCCESS 0x3666    // Muted green
-#define COLOR_ACCENT 0xFD20     // Orange accent
-#define COLOR_DAYTIME 0xFFDB    // Cornsilk #FFF8DC
-#define COLOR_MOON 0x9CD3       // Grey moon, slightly lighter than clouds
-#define COLOR_OVERCAST 0x4208   // Darker grey for overcast
-
-// Weather data (struct defined in types.h)
-WeatherData weather;
+uint32_t nextRepeatAt = 0;     // micros() of the next held LEFT/RIGHT step
+
+// Weather data (struct defined in types.h), double buffered per location
+// between the fetch task (core 0) and the render loop (core 1)
+LocationWeather locationWeather[LOCATION_COUNT];
+int currentLocation = 0;                                       // Location on screen (render side)
+const WeatherData *weather = &locationWeather[0].buffers[0]; // Render-side snapshot, only reseated by showWeather()
+ViewModel view;                                                // Derived from *weather by showWeather()
+
+// Fetches take turns across locations, spaced to fit the daily quota
+FetchRotation fetchRotation(LOCATION_COUNT, OWM_DAILY_QUOTA, UPDATE_INTERVAL);
+
+#ifdef WEATHER_RELAY_HOST
+// Compact MessagePack snapshots from a relay on the LAN (tools/relay) over
+// plain HTTP - no JSON and no TLS on the device
+#ifndef WEATHER_RELAY_PORT
+#define WEATHER_RELAY_PORT 8080
+#endif
+HttpConnection weatherSource(WEATHER_RELAY_HOST, WEATHER_RELAY_PORT);
+#else
+// Long-lived TLS connection to OpenWeatherMap, reused across fetches
+HttpsConnection weatherSource("api.openweathermap.org");
+#endif
+
+// Last good snapshot, kept across resets (RTC) and power loss (NVS)
+RTC_NOINIT_ATTR WeatherSnapshot rtcSnapshot;
+WeatherCache weatherCache(&rtcSnapshot);
+
+// Past readings of the first location (NVS), kept by the fetch task, and the
+// trend drawn from them, handed to the render loop once folded
+HistoryRing history;
+HistorySparkline pressureTrend(HIST_PRESSURE, 6, 4); // 30-minute columns, last 24 h, at least 4 hPa tall
+TrendHandoff shownPressureTrend(pressureTrend);
+const char *POSIX_TZ = "AEST-10"; // Same offset as configTime() - lets boot format cached times before NTP
+
+// Remembered AP and channel for fast rejoins
+RTC_NOINIT_ATTR WiFiLinkRecord rtcWiFiLink;
+WiFiLink wifiLink(WIFI_SSID, WIFI_PASSWORD, &rtcWiFiLink);
+bool timeSyncStarted = false;
+std::atomic<bool> fetchDeferred(false); // A fetch came due while offline - run it once back online
+std::atomic<bool> fetchRequested(false); // Set with each fetch wake-up, so other wake-ups can be told apart
+
+#ifdef SNAPSHOT_FANOUT
+// Leader/follower sharing of fetched snapshots between units on the LAN
+SnapshotFanout<LOCATION_COUNT> fanout(IPAddress(239, 0, 87, 88));
+const unsigned long FANOUT_BOOT_WAIT = 1500; // A leader answers a join within this
+#endif
+
+// Fetch latency, request to end of body, for the metrics endpoint
+LatencyHistogram fetchLatency;
+
+#ifdef METRICS_HTTP
+// /metrics and snapshot dumps for fleet monitoring
+MetricsServer metricsServer(perf, fetchLatency, inputLatency, wifiLink, locationWeather, LOCATIONS, LOCATION_COUNT,
+                            currentLocation);
+#endif
+
+// Stale marking of the location on screen, copied from its
+// LocationWeather when the render side takes or switches to it
+bool weatherStale = false;
+time_t staleSince = 0;
+
+// Background fetch task
+TaskHandle_t fetchTaskHandle = nullptr;
+std::atomic<bool> fetchInProgress(false);
+const uint32_t FETCH_TASK_STACK = 12288; // TLS handshake needs a deep stack
 
 // Last updated time
 String lastUpdateTime = "";
 
 // Function declarations
 void connectToWiFi();
-void fetchOneCallData();
+void startWiFi();
+void startTimeSync();
+void onLinkUp();
+void requestFetch();
+bool clockValid();
+void drawLinkGlyph(int x, int y);
+bool fetchOneCallData(const Location &where, WeatherData &out, uint8_t sections = SECTIONS_ALL);
+uint8_t dueSections(const WeatherData &data);
+void refreshWeather(int index);
+void recordHistory(const WeatherData &data);
+uint8_t takePublishedWeather();
+void showWeather(const WeatherData *data);
+void showLocation(int index);
+void fetchTask(void *param);
 void displayHourlyForecast();
 void displayHourlyForecast2();
 void displayConditions();
@@ -126,14 +263,198 @@ void displayDemo2();
 void displayDemo3();
 void displayConnecting();
 void displayError(String msg);
+bool initFrameBuffer();
+void clearFrame();
+void pushFrame();
+template <typename DrawFn>
+void renderFrame(DrawFn draw);
 void bootAnimation();
 void drawWeatherIcon(int code, int x, int y, int size, bool isNight = false);
+void renderWeatherIcon(TFT_eSprite &dst, int code, int x, int y, int size, bool isNight);
 void handleButtons();
+void attachButtonInterrupts();
+void detachButtonInterrupts();
+void lightSleepUntilNextEvent();
+void setDisplayPower(bool on);
+bool buttonsBusy();
+void onButtonChange(int button, ButtonChange change, uint32_t at);
+void autoSwitchJob();
+void colonFlashJob();
+void fetchDueJob();
+#ifdef SNAPSHOT_FANOUT
+void fanoutJob();
+void receiveFanout();
+#endif
+void statsJob();
+void perfRefreshJob();
+void drawPerfSummary();
 void drawScreenIndicator();
 void drawHeader();
 void drawFooter();
 void swipeTransition(Screen from, Screen to);
 void displayScreen(Screen screen);
+void drawScreen(Screen screen);
+
+// Every screen, in enum order - navigation, indicator dots and redraw policy
+constexpr ScreenInfo SCREENS[] = {
+    {SCREEN_HOURLY, GROUP_WEATHER, 0, displayHourlyForecast, PROBE_DISPLAY_HOURLY,
+     SECTION_BIT(SECTION_CURRENT) | SECTION_BIT(SECTION_HOURLY) | SECTION_BIT(SECTION_DAILY) | INPUT_STALE,
+     REFRESH_INPUTS, true},
+    {SCREEN_HOURLY2, GROUP_WEATHER, 1, displayHourlyForecast2, PROBE_DISPLAY_HOURLY2,
+     SECTION_BIT(SECTION_CURRENT) | SECTION_BIT(SECTION_HOURLY) | SECTION_BIT(SECTION_DAILY) | INPUT_STALE,
+     REFRESH_INPUTS, true},
+    {SCREEN_CONDITIONS, GROUP_WEATHER, 2, displayConditions, PROBE_DISPLAY_CONDITIONS,
+     SECTION_BIT(SECTION_CURRENT) | INPUT_STALE, REFRESH_INPUTS, true},
+    {SCREEN_DAILY, GROUP_WEATHER, 3, displayDailyForecast, PROBE_DISPLAY_DAILY,
+     SECTION_BIT(SECTION_DAILY) | INPUT_STALE, REFRESH_INPUTS, true},
+    {SCREEN_SETTINGS, GROUP_SETTINGS, 0, displaySettings, PROBE_DISPLAY_SETTINGS, INPUTS_ALL, REFRESH_LIVE, false},
+    {SCREEN_ABOUT, GROUP_SETTINGS, 1, displayAbout, PROBE_DISPLAY_ABOUT, 0, REFRESH_STATIC, false},
+    {SCREEN_DEMO, GROUP_SETTINGS, 2, displayDemo, PROBE_DISPLAY_DEMO, 0, REFRESH_STATIC, false},
+    {SCREEN_DEMO2, GROUP_SETTINGS, 3, displayDemo2, PROBE_DISPLAY_DEMO2, 0, REFRESH_STATIC, false},
+    {SCREEN_DEMO3, GROUP_SETTINGS, 4, displayDemo3, PROBE_DISPLAY_DEMO3, 0, REFRESH_STATIC, false},
+};
+static_assert(sizeof(SCREENS) / sizeof(SCREENS[0]) == SCREEN_DEMO3 + 1, "SCREENS must cover every Screen");
+static_assert(screenTableValid(SCREENS), "SCREENS must be in enum order with each group numbered from 0");
+
+// Inputs of the frame on the panel, and finished frames of the static screens
+ScreenInputs shownInputs;
+FrameCache staticFrames;
+
+// Pre-rendered weather icons (hits/misses readable for tuning)
+IconCache iconCache(&tft, renderWeatherIcon);
+#ifdef ASSET_PACK
+// Icons pre-rendered on the host, mapped from the assets partition
+AssetStore assets(&tft);
+#endif
+
+// Font advance tables for measuring text in the frame sprite's fonts
+TextMetrics text(&sprite);
+
+// Start a full redraw - clears the sprite and marks the whole frame dirty
+void clearFrame()
+{
+  sprite.fillSprite(COLOR_BG);
+  dirty.markAll();
+}
+// Allocate the frame sprite and output path, false if there is no memory for it
+bool initFrameBuffer()
+{
+#ifdef BANDED_RENDER
+  // Bands are already RGB565 in panel order, so they go out with a plain
+  // pushSprite - no 8-bit expansion and no DMA staging buffers
+  sprite.setColorDepth(16);
+  dmaOutput = false;
+  return sprite.createSprite(FRAME_WIDTH, BAND_HEIGHT) != nullptr;
+#else
+#ifdef PALETTE_FRAME
+  // 4-bit palette slots (palette.h) - half the RAM of the 8-bit frame
+  sprite.setColorDepth(4);
+  if (sprite.createSprite(FRAME_WIDTH, FRAME_HEIGHT) == nullptr)
+    return false;
+  sprite.createPalette(framePalette(), PALETTE_SIZE);
+  dmaPusher.setPalette(framePalette(), PALETTE_SIZE);
+#else
+  // 8-bit colour to save RAM
+  sprite.setColorDepth(8);
+  if (sprite.createSprite(FRAME_WIDTH, FRAME_HEIGHT) == nullptr)
+    return false;
+#endif
+  if (!dmaPusher.begin(tft))
+  {
+    Serial.println("DMA output unavailable - using synchronous pushSprite");
+    dmaOutput = false;
+  }
+  return true;
+#endif
+}
+
+// Run a drawing pass that ends in pushFrame(). Full-frame mode runs it once;
+// banded mode runs it per band. Later bands are skipped when the first pass
+// marked nothing in them, so partial updates (header, perf lines) only
+// redraw the bands they touch.
+template <typename DrawFn>
+void renderFrame(DrawFn draw)
+{
+#ifdef BANDED_RENDER
+  perf.beginBatch(PERF_FRAME_PROBES); // One sample per frame, not per band
+  for (int top = 0; top < FRAME_HEIGHT; top += BAND_HEIGHT)
+  {
+    if (top > 0 && !dirty.touchesRows(top, BAND_HEIGHT))
+      continue;
+    bandTop = top;
+    sprite.setViewport(0, -top, FRAME_WIDTH, top + BAND_HEIGHT); // Ends at the band's last row
+    draw();
+  }
+  sprite.resetViewport();
+  bandTop = 0;
+  dirty.clear();
+  perf.endBatch();
+#else
+  draw();
+#endif
+  if (inputPending && !skipPush)
+  {
+    inputLatency.record(micros() - inputAt);
+    inputPending = false;
+  }
+}
+
+// Send the dirty areas of the sprite to the panel using the active output mode
+void pushFrame()
+{
+  unsigned long start = micros();
+#ifdef BANDED_RENDER
+  // This band's share of the changed areas - renderFrame() clears them after the last band
+  dirty.forEachInRows(bandTop, BAND_HEIGHT, [](const DirtyRect &r)
+                      {
+                        if (r.w == FRAME_WIDTH && r.h == BAND_HEIGHT)
+                          sprite.pushSprite(0, r.y);
+                        else
+                          sprite.pushSprite(r.x, r.y, r.x, r.y - bandTop, r.w, r.h);
+                      });
+#else
+  // Redrawn areas that came out pixel-identical are dropped before the push
+  bool changed = frameDiff.narrow(sprite, dirty);
+  if (changed && dmaOutput && dmaPusher.ready())
+  {
+    dirty.flushWith([](const DirtyRect &r)
+                    { dmaPusher.push(tft, sprite, r.x, r.y, r.w, r.h); });
+  }
+  else if (changed)
+  {
+    dirty.flush(sprite);
+  }
+#endif
+  lastPushMicros = micros() - start;
+  perf.record(PROBE_PUSH, lastPushMicros);
+}
+
+#if defined(PUSH_BENCHMARK) && !defined(BANDED_RENDER)
+// Compare full-frame push time of the synchronous and DMA output paths
+void benchmarkPush()
+{
+  const int frames = 20;
+
+  unsigned long start = micros();
+  for (int i = 0; i < frames; i++)
+    sprite.pushSprite(0, 0);
+  unsigned long syncUs = (micros() - start) / frames;
+
+  unsigned long dmaUs = 0;
+  if (dmaPusher.ready())
+  {
+    start = micros();
+    for (int i = 0; i < frames; i++)
+      dmaPusher.push(tft, sprite, 0, 0, 320, 240);
+    dmaUs = (micros() - start) / frames;
+  }
+
+  int depth = sprite.getColorDepth();
+  Serial.printf("Push benchmark (%d-bit frame, %lu bytes, %d frames): sync %lu us/frame, DMA %lu us/frame\n", depth,
+                (unsigned long)FRAME_WIDTH * FRAME_HEIGHT * depth / 8, frames, syncUs, dmaUs);
+}
+#endif
+
 void drawHorizontalRule(int y) {
   int margin = 10;
   int lineWidth = 320 - (margin * 2);
@@ -146,42 +467,28 @@ void drawHourlyRange(int startIdx, int count, int yPos) {
   int availableWidth = 320 - (margin * 2);
 
   // Calculate how many we can actually show based on data availability
-  int actualCount = min(count, weather.hourlyCount - startIdx);
+  int actualCount = min(count, weather->hourlyCount - startIdx);
   if (actualCount <= 0) return;
 
   int spacing = availableWidth / actualCount;
 
-  // Get sunrise/sunset hours once for the daylight check
-  struct tm sunriseTm, sunsetTm;
-  localtime_r(&weather.sunrise, &sunriseTm);
-  localtime_r(&weather.sunset, &sunsetTm);
-
   for (int i = 0; i < actualCount; i++) {
     int hourIndex = startIdx + i;
     int x = margin + (spacing / 2) + (i * spacing);
+    const HourView &hour = view.hourly[hourIndex]; // Label, daylight and colour from the view model
 
-    // 1. Calculate Hour Label & Daylight status
-    int h = weather.hourly[hourIndex].hour;
-    bool hourIsDaytime = (h >= sunriseTm.tm_hour && h <= sunsetTm.tm_hour);
-
-    String ampm = (h < 12) ? "am" : "pm";
-    int displayH = h % 12;
-    if (displayH == 0) displayH = 12;
-    String hourStr = String(displayH) + ampm;
-
-    // 2. Draw Hour Label
+    // 1. Draw Hour Label
     sprite.setTextDatum(MC_DATUM);
     sprite.setTextFont(2);
-    sprite.setTextColor(hourIsDaytime ? COLOR_DAYTIME : COLOR_SUBTLE, COLOR_BG);
-    sprite.drawString(hourStr, x, yPos);
+    sprite.setTextColor(hour.daytime ? COLOR_DAYTIME : COLOR_SUBTLE, COLOR_BG);
+    sprite.drawString(hour.label, x, yPos);
 
-    // 3. Draw Icon
-    // Note: ensure your drawWeatherIcon function is accessible here
-    drawWeatherIcon(weather.hourly[hourIndex].weatherCode, x, yPos + 27, 35, !hourIsDaytime);
+    // 2. Draw Icon
+    drawWeatherIcon(weather->hourly[hourIndex].weatherCode, x, yPos + 27, 35, !hour.daytime);
 
-    // 4. Draw Temperature
-    sprite.setTextColor(getTempColor(weather.hourly[hourIndex].temperature), COLOR_BG);
-    sprite.drawString(String(weather.hourly[hourIndex].temperature, 0), x, yPos + 55);
+    // 3. Draw Temperature
+    sprite.setTextColor(hour.tempColor, COLOR_BG);
+    sprite.drawString(hour.temp, x, yPos + 55);
   }
 }
 void setup()
@@ -193,306 +500,520 @@ void setup()
   pinMode(BTN_LEFT, INPUT_PULLUP);
   pinMode(BTN_RIGHT, INPUT_PULLUP);
   pinMode(BTN_SELECT, INPUT_PULLUP);
+  loopTaskHandle = xTaskGetCurrentTaskHandle();
+  attachButtonInterrupts();
 
   tft.init();
   tft.setRotation(1); // Horizontal landscape mode (320x240)
   tft.invertDisplay(true);
-  tft.fillScreen(COLOR_BG);
+  tft.fillScreen(panelColor(COLOR_BG));
 
-  // Create sprite for flicker-free rendering (8-bit color to save RAM)
-  sprite.setColorDepth(8);
-  void* spritePtr = sprite.createSprite(320, 240);
-  if (spritePtr == nullptr) {
+  // Create sprite for flicker-free rendering
+  if (!initFrameBuffer()) {
     Serial.println("ERROR: Failed to create sprite - not enough memory!");
-    tft.setTextColor(TFT_RED, COLOR_BG);
+    tft.setTextColor(panelColor(COLOR_ALERT), panelColor(COLOR_BG));
     tft.drawString("Sprite alloc failed!", 10, 120);
     delay(2000);
   }
   sprite.setTextDatum(TL_DATUM);
+  text.begin();
+#ifdef ASSET_PACK
+  assets.begin();
+#endif
+
+  // Draw the last good forecast straight away if one survived the reset,
+  // and let WiFi come up in the background
+  history.load();
+  pressureTrend.update(history);
+  shownPressureTrend.publish(pressureTrend);
+  time_t cachedAt = 0;
+  LocationWeather &home = locationWeather[0];
+  bool cachedBoot = weatherCache.load(home.buffers[0], cachedAt);
+  if (cachedBoot)
+  {
+    setenv("TZ", POSIX_TZ, 1);
+    tzset();
+    home.lastGoodFetch = cachedAt;
+    home.stale = true;
+    home.staleSince = cachedAt;
+    showLocation(0);
+    displayScreen(SCREEN_HOURLY);
+    startWiFi(); // Joins in the background while loop() runs
+  }
+  else
+  {
+    connectToWiFi();
+  }
 
-  connectToWiFi();
-
-  // Show fetch status on screen (draw to tft during boot)
-  tft.drawString("Fetching weather data...", 10, 175);
-
-  fetchOneCallData();
-
-  tft.drawString("Done", 10, 203);
-  delay(500);
+  // Pin the OWM root CA when one is provided in credentials.h
+#if defined(WEATHER_RELAY_HOST)
+  Serial.printf("Weather from relay %s:%d\n", WEATHER_RELAY_HOST, WEATHER_RELAY_PORT);
+  weatherSource.begin(nullptr);
+#elif defined(OWM_ROOT_CA)
+  weatherSource.begin(OWM_ROOT_CA);
+#else
+  Serial.println("No OWM_ROOT_CA defined - server certificate will not be verified");
+  weatherSource.begin(nullptr);
+#endif
+
+  if (!cachedBoot)
+  {
+    // Show fetch status on screen (draw to tft during boot)
+    tft.drawString("Fetching weather data...", 10, 175);
+
+    // First fetch runs inline so the boot screen has data; later ones
+    // (and the other locations) run on core 0
+#ifdef SNAPSHOT_FANOUT
+    // A leader answers our join with its snapshots - only fetch without one
+    unsigned long waitStart = millis();
+    while (fanout.role() != FANOUT_FOLLOWER && millis() - waitStart < FANOUT_BOOT_WAIT)
+      delay(10);
+    delay(100); // Let the chunks land
+    receiveFanout();
+    if (!locationWeather[0].lastFetchOk)
+      refreshWeather(fetchRotation.next(time(NULL)));
+#else
+    refreshWeather(fetchRotation.next(time(NULL)));
+#endif
+    takePublishedWeather();
+
+    tft.drawString("Done", 10, 203);
+    delay(500);
 
-  displayHourlyForecast();
-  lastUpdate = millis();
+    displayScreen(SCREEN_HOURLY);
+  }
+#if defined(PUSH_BENCHMARK) && !defined(BANDED_RENDER)
+  benchmarkPush();
+#endif
+
+  xTaskCreatePinnedToCore(fetchTask, "fetch", FETCH_TASK_STACK, nullptr, 1, &fetchTaskHandle, 0);
+  perf.setTasks(loopTaskHandle, fetchTaskHandle);
+#ifdef METRICS_HTTP
+#ifdef ASSET_PACK
+  metricsServer.acceptAssets(&assets);
+#endif
+  metricsServer.begin();
+#endif
+
+  // A cached snapshot with nothing due (clock survived the reset) skips the
+  // boot fetch entirely; otherwise refresh it in the background now. Other
+  // locations have no cache and are filled in by the task straight away.
+  unsigned long fetchSpacing = fetchRotation.spacingMs();
+  unsigned long firstFetch = fetchSpacing;
+  if (cachedBoot && dueSections(home.buffers[0]) == 0)
+  {
+    time_t age = time(NULL) - cachedAt;
+    firstFetch = age * 1000UL < fetchSpacing ? fetchSpacing - age * 1000UL : 0;
+    Serial.printf("Cached snapshot is %ld s old - skipping boot fetch\n", (long)age);
+    fetchRotation.markFetched(0);
+  }
+  if (fetchRotation.hasUnfetched())
+    requestFetch();
+  Serial.printf("%d location(s): one fetch every %lu s, each refreshed every %lu s (budget %lu calls/day)\n",
+                LOCATION_COUNT, fetchSpacing / 1000, fetchRotation.cycleMs() / 1000,
+                (unsigned long)fetchRotation.dailyBudget());
+
+  pageJob = scheduler.every("page", PAGE_SWITCH_INTERVAL, autoSwitchJob, PAGE_SWITCH_INTERVAL);
+  colonJob = scheduler.every("colon", COLON_FLASH_INTERVAL, colonFlashJob, COLON_FLASH_INTERVAL);
+  scheduler.every("fetch", fetchSpacing, fetchDueJob, firstFetch);
+#ifdef SNAPSHOT_FANOUT
+  scheduler.every("fanout", fanout.HEARTBEAT_MS, fanoutJob, fanout.HEARTBEAT_MS);
+#endif
+  scheduler.every("stats", STATS_INTERVAL, statsJob, STATS_INTERVAL);
+  scheduler.every("perf", PERF_REFRESH_INTERVAL, perfRefreshJob, PERF_REFRESH_INTERVAL);
 }
 
 void loop()
 {
-  if (WiFi.status() != WL_CONNECTED)
-  {
-    Serial.println("WiFi disconnected. Reconnecting...");
-    connectToWiFi();
-    Serial.println("WiFi reconnected successfully.");
-  }
+  unsigned long loopStart = micros();
+  DutyCycleMeter::Mode powerMode = displayOn ? DutyCycleMeter::MODE_DISPLAY_ON : DutyCycleMeter::MODE_DISPLAY_OFF;
 
   handleButtons();
 
-  // Auto switch pages every 3 seconds
-  if (autoSwitch && millis() - lastPageSwitch >= PAGE_SWITCH_INTERVAL)
-  {
-    Screen nextScreen;
-    switch (currentScreen)
-    {
-    case SCREEN_HOURLY:
-      nextScreen = SCREEN_HOURLY2;
-      break;
-    case SCREEN_HOURLY2:
-      nextScreen = SCREEN_CONDITIONS;
-      break;
-    case SCREEN_CONDITIONS:
-      nextScreen = SCREEN_DAILY;
-      break;
-    case SCREEN_DAILY:
-      nextScreen = SCREEN_SETTINGS;
-      break;
-    case SCREEN_SETTINGS:
-      nextScreen = SCREEN_ABOUT;
-      break;
-    case SCREEN_ABOUT:
-      nextScreen = SCREEN_DEMO;
-      break;
-    case SCREEN_DEMO:
-      nextScreen = SCREEN_DEMO2;
-      break;
-    case SCREEN_DEMO2:
-      nextScreen = SCREEN_DEMO3;
-      break;
-    case SCREEN_DEMO3:
-      nextScreen = SCREEN_HOURLY;
-      break;
-    default:
-      nextScreen = SCREEN_HOURLY;
-      break;
-    }
-    swipeTransition(currentScreen, nextScreen);
-    currentScreen = nextScreen;
-    lastPageSwitch = millis();
-  }
+  // Advance the connection state machine; catch up on fetches missed offline
+  if (wifiLink.poll() && fetchDeferred)
+    requestFetch();
+
+#ifdef ASSET_PACK
+  // A new asset pack changes how icons look - drop frames drawn with the old one
+  if (assets.take())
+    staticFrames.clear();
+#endif
 
-  if (millis() - lastUpdate >= UPDATE_INTERVAL)
+  // Pick up a snapshot published by the fetch task; redraw only if the
+  // screen shows something that changed
+  uint8_t changed = takePublishedWeather();
+  if (changed != 0)
   {
-    Serial.println("Updating weather data...");
-    fetchOneCallData();
-    if (displayOn)
+    if (displayOn && showsInputs(SCREENS[currentScreen], changed))
     {
       displayScreen(currentScreen);
     }
-    lastUpdate = millis();
     Serial.print("Update complete. Next update in ");
-    Serial.print(UPDATE_INTERVAL / 60000);
+    Serial.print(fetchRotation.cycleMs() / 60000);
     Serial.println(" minutes.");
   }
 
-  // Flash colon in time display
-  if (displayOn && millis() - lastColonUpdate >= COLON_FLASH_INTERVAL)
+  scheduler.runDue();
+
+  dutyCycle.busy(powerMode, micros() - loopStart);
+
+  if (!displayOn)
   {
-    colonVisible = !colonVisible;
-    lastColonUpdate = millis();
-    // Only update header on screens that show it
-    if (currentScreen == SCREEN_HOURLY || currentScreen == SCREEN_HOURLY2 || currentScreen == SCREEN_CONDITIONS || currentScreen == SCREEN_DAILY)
-    {
-      drawHeader();
-      sprite.pushSprite(0, 0);
-    }
+    // Panel is off - sleep until a button edge or the next job
+    lightSleepUntilNextEvent();
+    return;
   }
 
-  delay(50);
+  // Block until the next deadline, a button edge, a WiFi event or new weather
+  unsigned long waitMs = min(scheduler.msUntilNext(), wifiLink.msUntilDeadline());
+  if (buttonsBusy())
+    waitMs = min(waitMs, HELD_BUTTON_POLL);
+  if (waitMs > 0)
+  {
+    unsigned long idleStart = micros();
+    ulTaskNotifyTake(pdTRUE, waitMs == Scheduler::NEVER ? portMAX_DELAY : pdMS_TO_TICKS(waitMs));
+    dutyCycle.idle(powerMode, micros() - idleStart);
+  }
 }
 
-void handleButtons()
+// Auto switch pages every 3 seconds
+void autoSwitchJob()
 {
-  bool leftPressed = digitalRead(BTN_LEFT) == LOW;
-  bool rightPressed = digitalRead(BTN_RIGHT) == LOW;
-  bool selectPressed = digitalRead(BTN_SELECT) == LOW;
+  if (!autoSwitch)
+    return;
+
+  ScreenStep step = stepAll(SCREENS, currentScreen);
+  if (step.wrapped)
+    showLocation((currentLocation + 1) % LOCATION_COUNT);
+  Screen previousScreen = currentScreen;
+  currentScreen = step.screen; // Before drawing - the indicator follows currentScreen
+  swipeTransition(previousScreen, currentScreen);
+}
 
-  // Handle SELECT long press detection
-  if (selectPressed)
+// Flash colon in time display
+void colonFlashJob()
+{
+  colonVisible = !colonVisible;
+  // Only update header on screens that show it
+  if (SCREENS[currentScreen].clock)
   {
-    if (!selectHeld && !longPressHandled)
-    {
-      selectPressStart = millis();
-      selectHeld = true;
-    }
-    else if (selectHeld && millis() - selectPressStart >= LONG_PRESS_TIME)
-    {
-      // Long press detected - toggle settings mode
-      selectHeld = false;
-      longPressHandled = true; // Prevent short-click on release
-      lastButtonPress = millis();
-      settingsMode = !settingsMode;
-      if (settingsMode)
-      {
-        currentScreen = SCREEN_SETTINGS;
-      }
-      else
-      {
-        currentScreen = SCREEN_HOURLY;
-      }
-      displayScreen(currentScreen);
-      return;
-    }
+    renderFrame([]
+                {
+                  drawHeader();
+                  pushFrame(); // Only the time box changed
+                });
+  }
+}
+
+// Hand the periodic refresh to the fetch task
+void fetchDueJob()
+{
+  requestFetch();
+}
+
+void requestFetch()
+{
+  fetchRequested = true;
+  if (fetchTaskHandle != nullptr)
+    xTaskNotifyGive(fetchTaskHandle);
+}
+
+#ifdef SNAPSHOT_FANOUT
+// Heartbeat as leader, or take over from a silent one
+void fanoutJob()
+{
+  if (wifiLink.hasIp() && fanout.tick(millis()))
+    requestFetch(); // Start fetching (and sharing) straight away
+}
+#endif
+
+void statsJob()
+{
+  dutyCycle.report();
+  scheduler.report();
+  frameDiff.report();
+  staticFrames.report();
+  inputLatency.report("Input to photon");
+  if (buttonEdges.dropped > 0)
+    Serial.printf("Buttons: %lu edges dropped (ring full)\n", (unsigned long)buttonEdges.dropped);
+#ifdef ASSET_PACK
+  assets.report();
+#endif
+  fetchRotation.report();
+#ifdef SNAPSHOT_FANOUT
+  fanout.report();
+#endif
+  perf.report();
+}
+
+// Keep the Settings screen's performance lines live
+void perfRefreshJob()
+{
+  if (displayOn && SCREENS[currentScreen].refresh == REFRESH_LIVE)
+  {
+    renderFrame([]
+                {
+                  drawPerfSummary();
+                  pushFrame();
+                });
+  }
+}
+
+// Panel power - the screen-only jobs are paused while it's off so they
+// don't wake the CPU out of light sleep
+void setDisplayPower(bool on)
+{
+  displayOn = on;
+  tft.writecommand(on ? 0x29 : 0x28);
+  if (on)
+  {
+    scheduler.reschedule(pageJob, PAGE_SWITCH_INTERVAL);
+    scheduler.reschedule(colonJob, COLON_FLASH_INTERVAL);
   }
   else
   {
-    // SELECT released
-    if (selectHeld && millis() - selectPressStart < LONG_PRESS_TIME)
-    {
-      // Short press - toggle display
-      selectHeld = false;
-      lastButtonPress = millis();
-      if (!displayOn)
-      {
-        displayOn = true;
-        tft.writecommand(0x29);
-        // Return to default screen when turning on
-        settingsMode = false;
-        currentScreen = SCREEN_HOURLY;
-        displayScreen(currentScreen);
-      }
-      else
-      {
-        displayOn = false;
-        tft.writecommand(0x28);
-      }
-      return;
-    }
-    selectHeld = false;
-    longPressHandled = false; // Reset for next press
+    scheduler.pause(pageJob);
+    scheduler.pause(colonJob);
   }
+}
 
-  // Debounce for left/right
-  if (millis() - lastButtonPress < DEBOUNCE_DELAY)
-    return;
+// A button is held or still settling - long press, repeat and debounce
+// need the loop to keep looking
+bool buttonsBusy()
+{
+  for (const DebouncedButton &b : buttons)
+  {
+    if (b.down || b.settling())
+      return true;
+  }
+  return false;
+}
 
-  // If display is off, any button turns it on
-  if (!displayOn && (leftPressed || rightPressed))
-  {
-    lastButtonPress = millis();
-    displayOn = true;
-    tft.writecommand(0x29);
-    // Return to default screen when turning on
-    settingsMode = false;
-    currentScreen = SCREEN_HOURLY;
-    displayScreen(currentScreen);
+// GPIO interrupt - ring every button edge with its timestamp
+void IRAM_ATTR onButtonEdge(void *arg)
+{
+  uint8_t pin = (uint8_t)(uintptr_t)arg;
+  buttonEdges.push({pin, (uint8_t)gpio_get_level((gpio_num_t)pin), (uint32_t)micros()});
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(loopTaskHandle, &woken);
+  if (woken)
+    portYIELD_FROM_ISR();
+}
+
+void attachButtonInterrupts()
+{
+  // Current levels first (the loop is the ring's producer while the
+  // interrupts are off): a press made at boot or the one that woke light
+  // sleep has no edge of its own
+  uint32_t now = micros();
+  for (uint8_t pin : BUTTON_PINS)
+  {
+    buttonEdges.push({pin, (uint8_t)digitalRead(pin), now});
+  }
+  for (uint8_t pin : BUTTON_PINS)
+  {
+    attachInterruptArg(digitalPinToInterrupt(pin), onButtonEdge, (void *)(uintptr_t)pin, CHANGE);
+  }
+}
+
+void detachButtonInterrupts()
+{
+  for (uint8_t pin : BUTTON_PINS)
+  {
+    detachInterrupt(digitalPinToInterrupt(pin));
+  }
+}
+
+// Light sleep with the panel off. Wakes on any button going low (GPIO wakeup)
+// or at the next scheduler deadline (timer wakeup).
+void lightSleepUntilNextEvent()
+{
+  unsigned long untilNext = min(scheduler.msUntilNext(), wifiLink.msUntilDeadline());
+  LinkState link = wifiLink.state();
+  bool joining = link == LINK_ASSOCIATING || link == LINK_DHCP || link == LINK_NTP;
+
+  // Stay awake while a fetch runs, WiFi is joining, a button is held or a job is imminent
+  if (fetchInProgress || joining || buttonsBusy() || untilNext < 100)
+  {
+    unsigned long idleStart = micros();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(min(untilNext, HELD_BUTTON_POLL)));
+    dutyCycle.idle(DutyCycleMeter::MODE_DISPLAY_OFF, micros() - idleStart);
     return;
   }
 
-  if (leftPressed || rightPressed)
+  Serial.flush();
+
+  // The wakeup level trigger replaces the edge interrupts while asleep
+  detachButtonInterrupts();
+  for (uint8_t pin : BUTTON_PINS)
   {
-    lastButtonPress = millis();
-    Screen previousScreen = currentScreen;
+    gpio_wakeup_enable((gpio_num_t)pin, GPIO_INTR_LOW_LEVEL);
+  }
+  esp_sleep_enable_gpio_wakeup();
+  if (untilNext != Scheduler::NEVER)
+    esp_sleep_enable_timer_wakeup((uint64_t)untilNext * 1000);
 
-    if (settingsMode)
+  unsigned long sleepStart = micros();
+  esp_light_sleep_start();
+  dutyCycle.slept(DutyCycleMeter::MODE_DISPLAY_OFF, micros() - sleepStart);
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+  for (uint8_t pin : BUTTON_PINS)
+  {
+    gpio_wakeup_disable((gpio_num_t)pin);
+  }
+  attachButtonInterrupts();
+}
+
+// Index of pin in BUTTON_PINS
+enum ButtonIndex
+{
+  BUTTON_LEFT,
+  BUTTON_RIGHT,
+  BUTTON_SELECT
+};
+
+int buttonIndex(uint8_t pin)
+{
+  for (int b = 0; b < BUTTON_COUNT; b++)
+  {
+    if (BUTTON_PINS[b] == pin)
+      return b;
+  }
+  return -1;
+}
+
+// Latency is measured for frames drawn between these, from the edge at
+void beginInput(uint32_t at)
+{
+  inputAt = at;
+  inputPending = true;
+}
+
+void endInput()
+{
+  inputPending = false; // Nothing was drawn (display turned off)
+}
+
+// Panel on, back at the default screen
+void wakeDisplay()
+{
+  setDisplayPower(true);
+  settingsMode = false;
+  currentScreen = SCREEN_HOURLY;
+  displayScreen(currentScreen);
+}
+
+void toggleSettingsMode()
+{
+  settingsMode = !settingsMode;
+  currentScreen = settingsMode ? SCREEN_SETTINGS : SCREEN_HOURLY;
+  displayScreen(currentScreen);
+}
+
+// Settings mode: Settings <-> About <-> Demo <-> Demo2 <-> Demo3
+// Weather mode: Hourly <-> Hourly2 <-> Conditions <-> Daily, wrapping
+// round onto the next or previous location
+void stepScreen(int dir)
+{
+  Screen previousScreen = currentScreen;
+  ScreenGroup group = settingsMode ? GROUP_SETTINGS : GROUP_WEATHER;
+  if (SCREENS[currentScreen].group != group)
+  {
+    currentScreen = screenAt(SCREENS, group, 0);
+  }
+  else
+  {
+    ScreenStep step = stepInGroup(SCREENS, currentScreen, dir);
+    if (step.wrapped && group == GROUP_WEATHER)
+      showLocation((currentLocation + LOCATION_COUNT + dir) % LOCATION_COUNT);
+    currentScreen = step.screen;
+  }
+
+  if (currentScreen != previousScreen)
+  {
+    swipeTransition(previousScreen, currentScreen);
+    scheduler.reschedule(pageJob, PAGE_SWITCH_INTERVAL);
+  }
+}
+
+// A debounced press or release of button at edge time at
+void onButtonChange(int button, ButtonChange change, uint32_t at)
+{
+  if (change == BUTTON_NONE)
+    return;
+
+  if (button == BUTTON_SELECT)
+  {
+    if (change == BUTTON_PRESSED)
     {
-      // Settings mode: Settings <-> About <-> Demo <-> Demo2 <-> Demo3
-      if (leftPressed)
-      {
-        switch (currentScreen)
-        {
-        case SCREEN_SETTINGS:
-          currentScreen = SCREEN_ABOUT;
-          break;
-        case SCREEN_ABOUT:
-          currentScreen = SCREEN_DEMO;
-          break;
-        case SCREEN_DEMO:
-          currentScreen = SCREEN_DEMO2;
-          break;
-        case SCREEN_DEMO2:
-          currentScreen = SCREEN_DEMO3;
-          break;
-        case SCREEN_DEMO3:
-          currentScreen = SCREEN_SETTINGS;
-          break;
-        default:
-          currentScreen = SCREEN_SETTINGS;
-          break;
-        }
-      }
-      else
-      {
-        switch (currentScreen)
-        {
-        case SCREEN_SETTINGS:
-          currentScreen = SCREEN_DEMO3;
-          break;
-        case SCREEN_ABOUT:
-          currentScreen = SCREEN_SETTINGS;
-          break;
-        case SCREEN_DEMO:
-          currentScreen = SCREEN_ABOUT;
-          break;
-        case SCREEN_DEMO2:
-          currentScreen = SCREEN_DEMO;
-          break;
-        case SCREEN_DEMO3:
-          currentScreen = SCREEN_DEMO2;
-          break;
-        default:
-          currentScreen = SCREEN_SETTINGS;
-          break;
-        }
-      }
+      selectPressAt = at;
+      longPressHandled = false;
+      return;
     }
+    if (longPressHandled)
+      return; // Already acted on while held
+
+    beginInput(at);
+    if (at - selectPressAt >= LONG_PRESS_TIME * 1000UL)
+      toggleSettingsMode(); // Held long, released before the loop looked
+    else if (!displayOn)
+      wakeDisplay(); // Short press - toggle display
     else
-    {
-      // Weather mode: Hourly <-> Hourly2 <-> Conditions <-> Daily
-      if (leftPressed)
-      {
-        switch (currentScreen)
-        {
-        case SCREEN_HOURLY:
-          currentScreen = SCREEN_HOURLY2;
-          break;
-        case SCREEN_HOURLY2:
-          currentScreen = SCREEN_CONDITIONS;
-          break;
-        case SCREEN_CONDITIONS:
-          currentScreen = SCREEN_DAILY;
-          break;
-        case SCREEN_DAILY:
-          currentScreen = SCREEN_HOURLY;
-          break;
-        default:
-          currentScreen = SCREEN_HOURLY;
-          break;
-        }
-      }
-      else
-      {
-        switch (currentScreen)
-        {
-        case SCREEN_HOURLY:
-          currentScreen = SCREEN_DAILY;
-          break;
-        case SCREEN_HOURLY2:
-          currentScreen = SCREEN_HOURLY;
-          break;
-        case SCREEN_CONDITIONS:
-          currentScreen = SCREEN_HOURLY2;
-          break;
-        case SCREEN_DAILY:
-          currentScreen = SCREEN_CONDITIONS;
-          break;
-        default:
-          currentScreen = SCREEN_HOURLY;
-          break;
-        }
-      }
-    }
+      setDisplayPower(false);
+    endInput();
+    return;
+  }
+
+  if (change != BUTTON_PRESSED)
+    return;
+  nextRepeatAt = at + REPEAT_INTERVAL * 1000UL;
+  beginInput(at);
+  // If display is off, any button turns it on
+  if (!displayOn)
+    wakeDisplay();
+  else
+    stepScreen(button == BUTTON_LEFT ? 1 : -1);
+  endInput();
+}
+
+void handleButtons()
+{
+  // Every edge since the last call, in order - presses made while the loop
+  // was busy are answered now, timed from when they happened
+  ButtonEvent event;
+  while (buttonEdges.pop(event))
+  {
+    int b = buttonIndex(event.pin);
+    if (b >= 0)
+      onButtonChange(b, buttons[b].edge(event.level == LOW, event.atMicros), event.atMicros);
+  }
+  uint32_t now = micros();
+  for (int b = 0; b < BUTTON_COUNT; b++)
+  {
+    onButtonChange(b, buttons[b].settle(now), buttons[b].changedAt);
+  }
+
+  // SELECT long press fires while still held, timed from its press edge
+  uint32_t longPressAt = selectPressAt + LONG_PRESS_TIME * 1000UL;
+  if (buttons[BUTTON_SELECT].down && !longPressHandled && (int32_t)(now - longPressAt) >= 0)
+  {
+    longPressHandled = true; // Prevent short-click on release
+    beginInput(longPressAt);
+    toggleSettingsMode();
+    endInput();
+  }
 
-    if (currentScreen != previousScreen)
+  // Held LEFT/RIGHT keeps stepping
+  for (int b = BUTTON_LEFT; b <= BUTTON_RIGHT; b++)
+  {
+    if (buttons[b].down && displayOn && (int32_t)(now - nextRepeatAt) >= 0)
     {
-      swipeTransition(previousScreen, currentScreen);
-      lastPageSwitch = millis();
+      nextRepeatAt = now + REPEAT_INTERVAL * 1000UL;
+      beginInput(now);
+      stepScreen(b == BUTTON_LEFT ? 1 : -1);
+      endInput();
     }
   }
 }
@@ -502,7 +1023,8 @@ void connectToWiFi()
   int lineY = 35;
   int lineHeight = 24;
 
-  tft.fillScreen(COLOR_BG);
+  tft.fillScreen(panelColor(COLOR_BG));
+  frameDiff.invalidate();
   sprite.setTextDatum(TL_DATUM);
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
 
@@ -519,18 +1041,17 @@ void connectToWiFi()
   sprite.drawString("Connecting to WiFi...", 10, lineY);
   lineY += lineHeight;
 
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 30)
+  // Boot has nothing to show yet, so wait here for an address
+  startWiFi();
+  unsigned long start = millis();
+  while (!wifiLink.hasIp() && millis() - start < WIFI_JOIN_TIMEOUT)
   {
-    delay(500);
+    wifiLink.poll();
+    delay(100);
     Serial.print(".");
-    attempts++;
   }
 
-  if (WiFi.status() == WL_CONNECTED)
+  if (wifiLink.hasIp())
   {
     Serial.println("\nWiFi Connected!");
     sprite.drawString("WiFi Connected!", 10, lineY);
@@ -541,20 +1062,63 @@ void connectToWiFi()
     sprite.drawString("IP: " + WiFi.localIP().toString(), 10, lineY);
     lineY += lineHeight;
 
-    configTime(10 * 3600, 0, "pool.ntp.org", "time.nist.gov");
-    Serial.println("Syncing time...");
-    sprite.drawString("Syncing time...", 10, lineY);
+    if (!clockValid())
+    {
+      Serial.println("Syncing time...");
+      sprite.drawString("Syncing time...", 10, lineY);
+    }
   }
   else
   {
+    // The state machine keeps retrying in the background
     Serial.println("\nWiFi Connection Failed!");
     sprite.drawString("WiFi Connection Failed!", 10, lineY);
   }
 }
 
+// Start the non-blocking join; loop() drives it from here on
+void startWiFi()
+{
+  wifiLink.setHooks([]()
+                    { xTaskNotifyGive(loopTaskHandle); },
+                    onLinkUp, clockValid);
+  wifiLink.begin();
+}
+
+bool clockValid()
+{
+  return time(NULL) > 1000000000;
+}
+
+// Start SNTP once per boot - it keeps polling on its own, so reconnects
+// don't restart it. A clock that survived the reset is used as-is meanwhile.
+void startTimeSync()
+{
+  if (timeSyncStarted)
+    return;
+  timeSyncStarted = true;
+  if (clockValid())
+    Serial.println("Clock still valid - NTP will correct it in the background");
+  configTime(10 * 3600, 0, "pool.ntp.org", "time.nist.gov");
+}
+
+// The link has an address (first join or a rejoin)
+void onLinkUp()
+{
+  startTimeSync();
+#ifdef SNAPSHOT_FANOUT
+  fanout.begin([]()
+               {
+                 if (fetchTaskHandle != nullptr)
+                   xTaskNotifyGive(fetchTaskHandle);
+               });
+#endif
+}
+
 void displayConnecting()
 {
-  tft.fillScreen(COLOR_BG);
+  tft.fillScreen(panelColor(COLOR_BG));
+  frameDiff.invalidate();
   sprite.setTextDatum(MC_DATUM);
   sprite.setTextFont(4);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
@@ -563,171 +1127,514 @@ void displayConnecting()
   sprite.drawString(WIFI_SSID, 160, 130);
 }
 
+// Shown in place of a screen - callers have already cleared the frame
 void displayError(String msg)
 {
-  tft.fillScreen(COLOR_BG);
   sprite.setTextDatum(MC_DATUM);
   sprite.setTextFont(4);
-  sprite.setTextColor(TFT_RED, COLOR_BG);
+  sprite.setTextColor(COLOR_ALERT, COLOR_BG);
   sprite.drawString(msg, 160, 120);
+  if (!skipPush) pushFrame();
 }
 
 
-void fetchOneCallData()
-{
-  if (WiFi.status() != WL_CONNECTED)
-  {
-    Serial.println("No WiFi connection!");
-    weather.dataValid = false;
-    return;
-  }
-
-  Serial.println("\nFetching One Call API 3.0 data...");
-
-  // Build One Call API 3.0 URL - include hourly and daily data
-  String url = "https://api.openweathermap.org/data/3.0/onecall?lat=";
-  url += LATITUDE;
-  url += "&lon=";
-  url += LONGITUDE;
-  url += "&units=metric&exclude=alerts&appid=";
-  url += OWM_API_KEY;
-
-  Serial.print("URL: ");
-  Serial.println(url);
+CountingAllocator jsonAllocator;
 
-  HTTPClient http;
-  http.setTimeout(10000);
-  http.begin(url);
-  int httpCode = http.GET();
+// Only the One Call fields that end up in WeatherData survive the streaming parse.
+// Array filters use element 0 as the template for every element.
+const JsonDocument &oneCallFilter()
+{
+  static JsonDocument filter;
+  static bool built = false;
+  if (built)
+    return filter;
+
+  JsonObject current = filter["current"].to<JsonObject>();
+  current["temp"] = true;
+  current["feels_like"] = true;
+  current["humidity"] = true;
+  current["wind_speed"] = true;
+  current["wind_deg"] = true;
+  current["sunrise"] = true;
+  current["sunset"] = true;
+  current["uvi"] = true;
+  current["visibility"] = true;
+  current["pressure"] = true;
+  current["dew_point"] = true;
+  current["clouds"] = true;
+  current["weather"][0]["id"] = true;
+  current["weather"][0]["description"] = true;
+
+  filter["minutely"][0]["precipitation"] = true;
+
+  JsonObject hourly = filter["hourly"][0].to<JsonObject>();
+  hourly["dt"] = true;
+  hourly["temp"] = true;
+  hourly["weather"][0]["id"] = true;
+
+  JsonObject daily = filter["daily"][0].to<JsonObject>();
+  daily["dt"] = true;
+  daily["temp"]["min"] = true;
+  daily["temp"]["max"] = true;
+  daily["pop"] = true;
+  daily["summary"] = true;
+  daily["moonrise"] = true;
+  daily["moonset"] = true;
+  daily["moon_phase"] = true;
+  daily["weather"][0]["id"] = true;
+
+  built = true;
+  return filter;
+}
 
-  Serial.print("HTTP Response code: ");
-  Serial.println(httpCode);
+// Copy the requested sections of a filtered One Call document into a
+// WeatherData buffer, leaving the other sections untouched
+void parseOneCallDocument(JsonDocument &doc, WeatherData &out, uint8_t sections)
+{
+  time_t now = time(NULL);
 
-  if (httpCode == 200)
+  if (sections & SECTION_BIT(SECTION_CURRENT))
   {
-    String payload = http.getString();
-    Serial.println("Response received");
+    // Current weather data
+    JsonObject current = doc["current"];
+    out.temperature = current["temp"];
+    out.apparent_temp = current["feels_like"];
+    out.humidity = current["humidity"];
+    out.windSpeed = current["wind_speed"];
+    out.windDeg = current["wind_deg"];
+    out.windDir = degToCompass(out.windDeg);
+    out.weatherCode = current["weather"][0]["id"];
+    strlcpy(out.condition, current["weather"][0]["description"] | "", sizeof(out.condition));
+
+    // Capitalize first letter
+    out.condition[0] = toupper(out.condition[0]);
+
+    // Sunrise/sunset data
+    out.sunrise = current["sunrise"].as<time_t>();
+    out.sunset = current["sunset"].as<time_t>();
+
+    // Additional current conditions
+    out.uvi = current["uvi"];
+    out.visibility = current["visibility"];
+    out.pressure = current["pressure"];
+    out.dewPoint = current["dew_point"];
+    out.clouds = current["clouds"];
+    out.sectionUpdated[SECTION_CURRENT] = now;
+  }
 
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, payload);
+  if (sections & SECTION_BIT(SECTION_MINUTELY))
+  {
+    // Minutely precipitation data (60 minutes)
+    out.hasMinutelyData = false;
+    for (int i = 0; i < 60; i++)
+    {
+      out.minutelyRain[i] = 0;
+    }
 
-    if (!error)
+    if (doc.containsKey("minutely"))
     {
-      // Current weather data
-      JsonObject current = doc["current"];
-      weather.temperature = current["temp"];
-      weather.apparent_temp = current["feels_like"];
-      weather.humidity = current["humidity"];
-      weather.windSpeed = current["wind_speed"];
-      weather.windDeg = current["wind_deg"];
-      weather.windDir = degToCompass(weather.windDeg);
-      weather.weatherCode = current["weather"][0]["id"];
-      weather.condition = current["weather"][0]["description"].as<String>();
-
-      // Capitalize first letter
-      if (weather.condition.length() > 0)
+      JsonArray minutely = doc["minutely"];
+      out.hasMinutelyData = true;
+      int count = min((int)minutely.size(), 60);
+      for (int i = 0; i < count; i++)
       {
-        weather.condition[0] = toupper(weather.condition[0]);
+        out.minutelyRain[i] = minutely[i]["precipitation"].as<float>();
       }
+    }
+    out.sectionUpdated[SECTION_MINUTELY] = now;
+  }
 
-      // Sunrise/sunset data
-      weather.sunrise = current["sunrise"].as<time_t>();
-      weather.sunset = current["sunset"].as<time_t>();
-
-      // Additional current conditions
-      weather.uvi = current["uvi"];
-      weather.visibility = current["visibility"];
-      weather.pressure = current["pressure"];
-      weather.dewPoint = current["dew_point"];
-      weather.clouds = current["clouds"];
-
-      // Minutely precipitation data (60 minutes)
-      weather.hasMinutelyData = false;
-      for (int i = 0; i < 60; i++)
+  if (sections & SECTION_BIT(SECTION_HOURLY))
+  {
+    // Hourly forecast data
+    out.hourlyCount = 0;
+    if (doc.containsKey("hourly"))
+    {
+      JsonArray hourly = doc["hourly"];
+      out.hourlyCount = min((int)hourly.size(), 24);
+      for (int i = 0; i < out.hourlyCount; i++)
       {
-        weather.minutelyRain[i] = 0;
+        out.hourly[i].temperature = hourly[i]["temp"];
+        out.hourly[i].weatherCode = hourly[i]["weather"][0]["id"];
+        // Get hour from timestamp
+        time_t ts = hourly[i]["dt"];
+        struct tm *timeinfo = localtime(&ts);
+        out.hourly[i].hour = timeinfo->tm_hour;
       }
+    }
+    out.sectionUpdated[SECTION_HOURLY] = now;
+  }
 
-      if (doc.containsKey("minutely"))
+  if (sections & SECTION_BIT(SECTION_DAILY))
+  {
+    // Daily forecast data
+    out.dailyCount = 0;
+    if (doc.containsKey("daily"))
+    {
+      JsonArray daily = doc["daily"];
+      out.dailyCount = min((int)daily.size(), 8);
+      for (int i = 0; i < out.dailyCount; i++)
       {
-        JsonArray minutely = doc["minutely"];
-        weather.hasMinutelyData = true;
-        int count = min((int)minutely.size(), 60);
-        for (int i = 0; i < count; i++)
-        {
-          weather.minutelyRain[i] = minutely[i]["precipitation"].as<float>();
-        }
+        out.daily[i].tempMin = daily[i]["temp"]["min"];
+        out.daily[i].tempMax = daily[i]["temp"]["max"];
+        out.daily[i].weatherCode = daily[i]["weather"][0]["id"];
+        out.daily[i].pop = (int)(daily[i]["pop"].as<float>() * 100 + 0.5f); // 0-1 to 0-100%, rounded as the relay does
+        strlcpy(out.daily[i].summary, daily[i]["summary"] | "", sizeof(out.daily[i].summary));
+        // Get day name from timestamp
+        time_t ts = daily[i]["dt"];
+        struct tm *timeinfo = localtime(&ts);
+        out.daily[i].dayName = shortDayName(timeinfo->tm_wday);
       }
+      // Moon data from today (daily[0])
+      out.moonrise = daily[0]["moonrise"].as<time_t>();
+      out.moonset = daily[0]["moonset"].as<time_t>();
+      out.moonPhase = daily[0]["moon_phase"];
+    }
+    out.sectionUpdated[SECTION_DAILY] = now;
+  }
 
-      // Hourly forecast data
-      weather.hourlyCount = 0;
-      if (doc.containsKey("hourly"))
-      {
-        JsonArray hourly = doc["hourly"];
-        weather.hourlyCount = min((int)hourly.size(), 24);
-        for (int i = 0; i < weather.hourlyCount; i++)
-        {
-          weather.hourly[i].temperature = hourly[i]["temp"];
-          weather.hourly[i].weatherCode = hourly[i]["weather"][0]["id"];
-          // Get hour from timestamp
-          time_t ts = hourly[i]["dt"];
-          struct tm *timeinfo = localtime(&ts);
-          weather.hourly[i].hour = timeinfo->tm_hour;
-        }
-      }
+  out.dataValid = true;
+}
 
-      // Daily forecast data
-      weather.dailyCount = 0;
-      if (doc.containsKey("daily"))
-      {
-        JsonArray daily = doc["daily"];
-        weather.dailyCount = min((int)daily.size(), 8);
-        const char *dayNames[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
-        for (int i = 0; i < weather.dailyCount; i++)
-        {
-          weather.daily[i].tempMin = daily[i]["temp"]["min"];
-          weather.daily[i].tempMax = daily[i]["temp"]["max"];
-          weather.daily[i].weatherCode = daily[i]["weather"][0]["id"];
-          weather.daily[i].pop = (int)(daily[i]["pop"].as<float>() * 100); // Convert 0-1 to 0-100%
-          weather.daily[i].summary = daily[i]["summary"].as<String>();
-          // Get day name from timestamp
-          time_t ts = daily[i]["dt"];
-          struct tm *timeinfo = localtime(&ts);
-          weather.daily[i].dayName = dayNames[timeinfo->tm_wday];
-        }
-        // Moon data from today (daily[0])
-        weather.moonrise = daily[0]["moonrise"].as<time_t>();
-        weather.moonset = daily[0]["moonset"].as<time_t>();
-        weather.moonPhase = daily[0]["moon_phase"];
-      }
+// Sections whose refresh interval has elapsed, give or take half a fetch
+// cycle: sections are stamped once their download is done, so a section
+// refreshed every cycle is always a few seconds short of its interval by
+// the next fetch of its location, and would otherwise wait a whole extra
+// cycle. Daily is also due once the local date changes, so "Today" never
+// lags behind midnight.
+uint8_t dueSections(const WeatherData &data)
+{
+  time_t now = time(NULL);
+  if (now < 1000000000 || !data.dataValid)
+    return SECTIONS_ALL; // Clock not synced or nothing usable yet
 
-      weather.dataValid = true;
+  time_t slack = fetchRotation.cycleMs() / 2000;
+  uint8_t due = 0;
+  for (int s = 0; s < SECTION_COUNT; s++)
+  {
+    time_t last = data.sectionUpdated[s];
+    if (last == 0 || now - last + slack >= (time_t)SECTION_INTERVAL[s])
+      due |= SECTION_BIT(s);
+  }
+
+  struct tm nowTm, lastTm;
+  time_t lastDaily = data.sectionUpdated[SECTION_DAILY];
+  localtime_r(&now, &nowTm);
+  localtime_r(&lastDaily, &lastTm);
+  if (nowTm.tm_yday != lastTm.tm_yday)
+    due |= SECTION_BIT(SECTION_DAILY);
+
+  return due;
+}
+
+bool fetchOneCallData(const Location &where, WeatherData &out, uint8_t sections)
+{
+  if (WiFi.status() != WL_CONNECTED)
+  {
+    Serial.println("No WiFi connection!");
+    out.dataValid = false;
+    return false;
+  }
+
+#ifdef WEATHER_RELAY_HOST
+  Serial.print("\nFetching relay snapshot for ");
+#else
+  Serial.print("\nFetching One Call API 3.0 data for ");
+#endif
+  Serial.println(where.name);
+
+  // Exclude alerts and every section that isn't due
+  char exclude[48] = "alerts";
+  Serial.print("Sections:");
+  for (int s = 0; s < SECTION_COUNT; s++)
+  {
+    if (sections & SECTION_BIT(s))
+    {
+      Serial.print(" ");
+      Serial.print(SECTION_NAMES[s]);
+    }
+    else
+    {
+      strlcat(exclude, ",", sizeof(exclude));
+      strlcat(exclude, SECTION_NAMES[s], sizeof(exclude));
+    }
+  }
+  Serial.println();
+
+  char path[256];
+#ifdef WEATHER_RELAY_HOST
+  // The relay holds the API key and asks OWM on our behalf
+  snprintf(path, sizeof(path), "/v%d/snapshot?lat=%s&lon=%s&sections=%u",
+           RELAY_SNAPSHOT_VERSION, where.latitude, where.longitude, (unsigned)sections);
+#else
+  // Build One Call API 3.0 request path
+  snprintf(path, sizeof(path), "/data/3.0/onecall?lat=%s&lon=%s&units=metric&exclude=%s&appid=%s",
+           where.latitude, where.longitude, exclude, OWM_API_KEY);
+#endif
+
+  Serial.print("Path: ");
+  Serial.println(path);
+
+  // Track the heap low-water mark across the fetch
+  uint32_t heapBefore = ESP.getFreeHeap();
+  uint32_t heapLow = heapBefore;
+
+  unsigned long requestStart = millis();
+  int httpCode = weatherSource.get(path);
+  heapLow = min(heapLow, ESP.getFreeHeap());
+
+  Serial.print("HTTP Response code: ");
+  Serial.println(httpCode);
+
+  if (httpCode == 200)
+  {
+    // Parse directly from the stream - the raw payload is never held in RAM
+    jsonAllocator.reset();
+    JsonDocument doc(&jsonAllocator);
+#ifdef WEATHER_RELAY_HOST
+    DeserializationError error = deserializeMsgPack(doc, weatherSource.body());
+    bool parsed = !error && parseRelaySnapshot(doc, out, sections); // Explains a schema mismatch itself
+#else
+    DeserializationError error = deserializeJson(doc, weatherSource.body(), DeserializationOption::Filter(oneCallFilter()));
+    bool parsed = !error;
+    if (parsed)
+      parseOneCallDocument(doc, out, sections);
+#endif
+    heapLow = min(heapLow, ESP.getFreeHeap());
+    Serial.println("Response received");
+
+    if (parsed)
+    {
 
       Serial.println("\n=== Weather Data ===");
       Serial.print("Temperature: ");
-      Serial.print(weather.temperature);
+      Serial.print(out.temperature);
       Serial.println(" C");
       Serial.print("Hourly points: ");
-      Serial.println(weather.hourlyCount);
+      Serial.println(out.hourlyCount);
       Serial.print("Daily points: ");
-      Serial.println(weather.dailyCount);
+      Serial.println(out.dailyCount);
       Serial.println("====================\n");
     }
     else
     {
-      Serial.print("JSON parse error: ");
-      Serial.println(error.c_str());
-      weather.dataValid = false;
+      if (error)
+      {
+        Serial.print("Parse error: ");
+        Serial.println(error.c_str());
+      }
+      out.dataValid = false;
     }
   }
   else
   {
     Serial.print("HTTP error: ");
     Serial.println(httpCode);
-    weather.dataValid = false;
+    out.dataValid = false;
+  }
+
+  // Drain the body so the connection stays open for the next fetch
+  weatherSource.finish();
+
+  const FetchPhases &phases = weatherSource.lastPhases();
+  unsigned long totalMs = millis() - requestStart;
+  perf.record(PROBE_FETCH_TOTAL, totalMs * 1000);
+  fetchLatency.record(totalMs);
+  if (!phases.dnsCached && !phases.reused)
+    perf.record(PROBE_FETCH_DNS, phases.dnsMs * 1000);
+  if (!phases.reused)
+    perf.record(PROBE_FETCH_CONNECT, phases.connectMs * 1000);
+  perf.record(PROBE_FETCH_FIRST_BYTE, phases.firstByteMs * 1000);
+  perf.record(PROBE_FETCH_BODY, phases.bodyMs * 1000);
+  Serial.printf("Fetch phases: dns %u ms%s, connect+tls %u ms%s, first byte %u ms, body %u ms\n",
+                (unsigned)phases.dnsMs, phases.dnsCached ? " (cached)" : "",
+                (unsigned)phases.connectMs, phases.reused ? " (reused)" : "",
+                (unsigned)phases.firstByteMs, (unsigned)phases.bodyMs);
+  if (wifiLink.connectedAt != 0)
+  {
+    // First request on a new link - the fast-join target is under 1 s
+    unsigned long firstByteAt = requestStart + phases.dnsMs + phases.connectMs + phases.firstByteMs;
+    Serial.printf("WiFi association to first byte: %lu ms (join %lu ms, %s)\n",
+                  firstByteAt - wifiLink.connectedAt, wifiLink.lastJoinMs, wifiLink.lastWasFast ? "fast" : "scan");
+    wifiLink.connectedAt = 0;
+  }
+  Serial.printf("Fetch heap: JSON doc peak %u bytes in %u allocations, free low %u (peak used %u)\n",
+                (unsigned)jsonAllocator.peak, (unsigned)jsonAllocator.allocations, (unsigned)heapLow, (unsigned)(heapBefore - heapLow));
+
+  return out.dataValid;
+}
+
+// Fetch side: the buffer the render side is not reading. If the last
+// publish hasn't been picked up yet it is revoked and reused, so the render
+// side never sees a buffer that is being written.
+int claimBackBuffer(LocationWeather &loc)
+{
+  loc.writes++;
+  int revoked = loc.pending.exchange(-1);
+  return (revoked >= 0) ? revoked : 1 - loc.published;
+}
+
+void publishBuffer(LocationWeather &loc, int back)
+{
+  loc.published = back;
+  loc.pending.store(back);
+  loc.writes++;
+}
+
+// Give back a claimed buffer that wasn't written after all
+void abandonBackBuffer(LocationWeather &loc, int back)
+{
+  if (back == loc.published)
+    loc.pending.store(back); // It was a revoked publish - put it back
+  loc.writes++;
+}
+
+// Fetch side: add the first location's new reading to the history, save it
+// and hand the render loop the updated trend. Done here rather than on the
+// render loop, whose frames and buttons would stall on the NVS writes.
+void recordHistory(const WeatherData &data)
+{
+  // A buffer whose current section wasn't refreshed lands in the same slot and is skipped
+  if (!history.append(data.sectionUpdated[SECTION_CURRENT], data))
+    return;
+  history.persist(time(NULL));
+  pressureTrend.update(history);
+  shownPressureTrend.publish(pressureTrend);
+}
+
+// Fetch one location into its back buffer, then publish it
+void refreshWeather(int index)
+{
+  LocationWeather &loc = locationWeather[index];
+  uint8_t due = dueSections(loc.buffers[loc.published]);
+  if (due == 0)
+  {
+    // A request excluding everything would still count against the quota
+    Serial.printf("%s: nothing due - fetch skipped\n", LOCATIONS[index].name);
+    fetchRotation.refund();
+    return;
+  }
+
+  fetchInProgress = true;
+  int back = claimBackBuffer(loc);
+
+  // Start from the newest snapshot so sections that aren't due carry over
+  if (back != loc.published)
+    loc.buffers[back] = loc.buffers[loc.published];
+
+  WeatherData &next = loc.buffers[back];
+  bool hadData = next.dataValid;
+  loc.lastFetchOk = fetchOneCallData(LOCATIONS[index], next, due);
+  if (loc.lastFetchOk)
+  {
+    loc.lastGoodFetch = time(NULL);
+    if (index == 0)
+    {
+      weatherCache.save(next, loc.lastGoodFetch); // Only the first location survives a reset
+      recordHistory(next);
+    }
+  }
+  else if (hadData)
+  {
+    // The failed fetch left the old data untouched - keep showing it, marked stale
+    next.dataValid = true;
+  }
+
+#ifdef SNAPSHOT_FANOUT
+  if (loc.lastFetchOk)
+    fanout.share(index, next, loc.lastGoodFetch);
+#endif
+
+  publishBuffer(loc, back);
+  fetchInProgress = false;
+}
+
+#ifdef SNAPSHOT_FANOUT
+// Fetch side: publish snapshots heard from the leader as if fetched here,
+// and answer a joining unit with ours when leading
+void receiveFanout()
+{
+  for (int i = 0; i < LOCATION_COUNT; i++)
+  {
+    if (!fanout.ready(i))
+      continue;
+    LocationWeather &loc = locationWeather[i];
+    int back = claimBackBuffer(loc);
+    time_t fetchedAt;
+    if (fanout.take(i, loc.buffers[back], fetchedAt))
+    {
+      loc.lastFetchOk = true;
+      loc.lastGoodFetch = fetchedAt;
+      if (i == 0)
+      {
+        weatherCache.save(loc.buffers[back], fetchedAt);
+        recordHistory(loc.buffers[back]);
+      }
+      fetchRotation.markFetched(i);
+      publishBuffer(loc, back);
+      xTaskNotifyGive(loopTaskHandle);
+    }
+    else
+    {
+      abandonBackBuffer(loc, back); // Bad snapshot
+    }
   }
 
-  http.end();
+  if (fanout.resendWanted())
+  {
+    for (int i = 0; i < LOCATION_COUNT; i++)
+    {
+      const LocationWeather &loc = locationWeather[i];
+      if (loc.lastFetchOk)
+        fanout.share(i, loc.buffers[loc.published], loc.lastGoodFetch);
+    }
+  }
+}
+#endif
+
+// Render side: put a snapshot on screen, deriving its view data once
+void showWeather(const WeatherData *data)
+{
+  weather = data;
+  view.build(*data, text);
+}
+
+// Render side: put a location's newest taken snapshot on screen - no fetch,
+// so switching locations is as quick as a redraw
+void showLocation(int index)
+{
+  LocationWeather &loc = locationWeather[index];
+  currentLocation = index;
+  showWeather(&loc.buffers[loc.shown]);
+  weatherStale = loc.stale;
+  staleSince = loc.staleSince;
+  shownInputs.take(*weather, weatherStale);
+}
+
+// Render side: take the newest published snapshot of every location.
+// Returns the inputs (screens.h) that changed for the one on screen.
+uint8_t takePublishedWeather()
+{
+  uint8_t changed = 0;
+  for (int i = 0; i < LOCATION_COUNT; i++)
+  {
+    LocationWeather &loc = locationWeather[i];
+    int published = loc.pending.exchange(-1);
+    if (published < 0)
+      continue;
+
+    loc.shown = published;
+    loc.stale = !loc.lastFetchOk;
+    loc.staleSince = loc.lastGoodFetch;
+    if (i == currentLocation)
+    {
+      // A refreshed section counts as changed even if its values came out the same
+      changed = shownInputs.diff(loc.buffers[published], loc.stale);
+      showLocation(i);
+    }
+  }
+  if (changed == 0)
+    return 0;
 
   // Update time
   struct tm timeinfo;
@@ -737,10 +1644,88 @@ void fetchOneCallData()
     strftime(timeStr, sizeof(timeStr), "%H:%M", &timeinfo);
     lastUpdateTime = String(timeStr);
   }
+  return changed;
+}
+
+// Fetch task pinned to core 0 - network waits never stall rendering on core 1
+void fetchTask(void *param)
+{
+  for (;;)
+  {
+    // Sleep until the scheduler's fetch job (or an early refresh) notifies us
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+#ifdef SNAPSHOT_FANOUT
+    receiveFanout();
+#endif
+    if (!fetchRequested.exchange(false))
+      continue;
+
+    if (!wifiLink.hasIp())
+    {
+      // loop() re-notifies when the link comes back
+      Serial.printf("WiFi %s - fetch deferred\n", wifiLink.stateName());
+      fetchDeferred = true;
+      continue;
+    }
+    fetchDeferred = false;
+
+#ifdef SNAPSHOT_FANOUT
+    // Followers leave fetching to the leader while it keeps them fed, and
+    // wait for the election to settle before fetching at all
+    if (fanout.role() == FANOUT_LISTENING ||
+        fanout.leaderFeeding(millis(), 2 * fetchRotation.cycleMs()))
+    {
+      Serial.printf("Fan-out %s - fetch left to the leader\n", fanout.roleName());
+      continue;
+    }
+#endif
+
+    // This tick's location, then any that have never been fetched (boot)
+    int index = fetchRotation.next(time(NULL));
+    if (index < 0)
+    {
+      Serial.printf("Daily OWM budget of %lu calls spent - fetch skipped\n", (unsigned long)fetchRotation.dailyBudget());
+      continue;
+    }
+    do
+    {
+      Serial.println("Updating weather data...");
+      refreshWeather(index);
+      xTaskNotifyGive(loopTaskHandle); // Wake the render loop to pick it up
+    } while (fetchRotation.hasUnfetched() && (index = fetchRotation.next(time(NULL))) >= 0);
+  }
 }
 
-// Draw weather icon using TFT primitives
+// Draw weather icon - blits it from the asset pack, or a cached raster
+// rendered on first use
 void drawWeatherIcon(int code, int x, int y, int size, bool isNight)
+{
+  ScopedTimer timer(perf, PROBE_ICON);
+#ifdef ASSET_PACK
+  if (assets.pack.draw(sprite, code, x, y, size, isNight))
+    return;
+#endif
+  iconCache.draw(sprite, code, x, y, size, isNight);
+}
+
+// Draw the rays of a sun centred on (x, y) from precomputed offsets
+void drawSunRays(TFT_eSprite &dst, int x, int y, const SunRayTemplate &rays)
+{
+  fixed_t cx = intToFixed(x);
+  fixed_t cy = intToFixed(y);
+  for (int i = 0; i < SUN_RAY_COUNT; i++)
+  {
+    int next = (i + 1) % SUN_RAY_COUNT;
+    dst.fillTriangle(fixedToInt(cx + rays.tipX[i]), fixedToInt(cy + rays.tipY[i]),
+                     fixedToInt(cx + rays.baseX[i]), fixedToInt(cy + rays.baseY[i]),
+                     fixedToInt(cx + rays.baseX[next]), fixedToInt(cy + rays.baseY[next]),
+                     COLOR_SUN);
+  }
+}
+
+// Render weather icon into any sprite using TFT primitives
+void renderWeatherIcon(TFT_eSprite &dst, int code, int x, int y, int size, bool isNight)
 {
   int r = size / 2;
 
@@ -749,33 +1734,18 @@ void drawWeatherIcon(int code, int x, int y, int size, bool isNight)
     if (isNight)
     {
       // Clear sky at night - moon with craters
-      sprite.fillCircle(x, y, r * 0.5, COLOR_MOON);
+      dst.fillCircle(x, y, r * 0.5, COLOR_MOON);
       // Subtle darker craters
-      uint16_t craterColor = 0x8410; // Darker grey
-      sprite.fillCircle(x - r * 0.15, y - r * 0.1, r * 0.12, craterColor);
-      sprite.fillCircle(x + r * 0.2, y + r * 0.15, r * 0.08, craterColor);
-      sprite.fillCircle(x - r * 0.05, y + r * 0.25, r * 0.06, craterColor);
+      uint16_t craterColor = COLOR_SUBTLE; // Darker grey
+      dst.fillCircle(x - r * 0.15, y - r * 0.1, r * 0.12, craterColor);
+      dst.fillCircle(x + r * 0.2, y + r * 0.15, r * 0.08, craterColor);
+      dst.fillCircle(x - r * 0.05, y + r * 0.25, r * 0.06, craterColor);
     }
     else
     {
       // Clear sky - sun with 12 short pointed rays and orange center
-      int numRays = 12;
-      float outerR = r * 0.75; // Shorter rays
-      float innerR = r * 0.55;
-      for (int i = 0; i < numRays; i++)
-      {
-        float angle = i * (360.0 / numRays) * 0.0174533;
-        float nextAngle = (i + 1) * (360.0 / numRays) * 0.0174533;
-        float midAngle = (angle + nextAngle) / 2;
-        int tipX = x + cos(midAngle) * outerR;
-        int tipY = y + sin(midAngle) * outerR;
-        int base1X = x + cos(angle) * innerR;
-        int base1Y = y + sin(angle) * innerR;
-        int base2X = x + cos(nextAngle) * innerR;
-        int base2Y = y + sin(nextAngle) * innerR;
-        sprite.fillTriangle(tipX, tipY, base1X, base1Y, base2X, base2Y, COLOR_SUN);
-      }
-      sprite.fillCircle(x, y, r * 0.56, COLOR_ACCENT); // Slightly larger to cover ray bases
+      drawSunRays(dst, x, y, sunRaysFor(size, SUN_CLEAR));
+      dst.fillCircle(x, y, r * 0.56, COLOR_ACCENT); // Slightly larger to cover ray bases
     }
   }
   else if (code == 801)
@@ -785,144 +1755,129 @@ void drawWeatherIcon(int code, int x, int y, int size, bool isNight)
       // Few clouds at night - moon with craters behind cloud
       int moonX = x - r * 0.3;
       int moonY = y - r * 0.2;
-      sprite.fillCircle(moonX, moonY, r * 0.3, COLOR_MOON);
-      uint16_t craterColor = 0x8410;
-      sprite.fillCircle(moonX - r * 0.1, moonY - r * 0.05, r * 0.07, craterColor);
-      sprite.fillCircle(moonX + r * 0.1, moonY + r * 0.08, r * 0.05, craterColor);
+      dst.fillCircle(moonX, moonY, r * 0.3, COLOR_MOON);
+      uint16_t craterColor = COLOR_SUBTLE;
+      dst.fillCircle(moonX - r * 0.1, moonY - r * 0.05, r * 0.07, craterColor);
+      dst.fillCircle(moonX + r * 0.1, moonY + r * 0.08, r * 0.05, craterColor);
     }
     else
     {
       // Few clouds - sun with 12 short rays behind cloud
       int sunX = x - r * 0.3;
       int sunY = y - r * 0.2;
-      int numRays = 12;
-      float outerR = r * 0.48; // Shorter rays
-      float innerR = r * 0.35;
-      for (int i = 0; i < numRays; i++)
-      {
-        float angle = i * (360.0 / numRays) * 0.0174533;
-        float nextAngle = (i + 1) * (360.0 / numRays) * 0.0174533;
-        float midAngle = (angle + nextAngle) / 2;
-        int tipX = sunX + cos(midAngle) * outerR;
-        int tipY = sunY + sin(midAngle) * outerR;
-        int base1X = sunX + cos(angle) * innerR;
-        int base1Y = sunY + sin(angle) * innerR;
-        int base2X = sunX + cos(nextAngle) * innerR;
-        int base2Y = sunY + sin(nextAngle) * innerR;
-        sprite.fillTriangle(tipX, tipY, base1X, base1Y, base2X, base2Y, COLOR_SUN);
-      }
-      sprite.fillCircle(sunX, sunY, r * 0.36, COLOR_ACCENT); // Slightly larger to cover ray bases
+      drawSunRays(dst, sunX, sunY, sunRaysFor(size, SUN_BEHIND_CLOUD));
+      dst.fillCircle(sunX, sunY, r * 0.36, COLOR_ACCENT); // Slightly larger to cover ray bases
     }
     // Cloud with depth - dark base, mid layer, light highlights
-    sprite.fillCircle(x + r * 0.15, y + r * 0.35, r * 0.3, COLOR_CLOUD_DARK); // Shadow
-    sprite.fillCircle(x + r * 0.1, y + r * 0.2, r * 0.35, COLOR_CLOUD_MID);
-    sprite.fillCircle(x + r * 0.4, y + r * 0.3, r * 0.3, COLOR_CLOUD_MID);
-    sprite.fillCircle(x - r * 0.2, y + r * 0.3, r * 0.25, COLOR_CLOUD_MID);
-    sprite.fillCircle(x + r * 0.05, y + r * 0.15, r * 0.2, COLOR_CLOUD); // Highlight
+    dst.fillCircle(x + r * 0.15, y + r * 0.35, r * 0.3, COLOR_CLOUD_DARK); // Shadow
+    dst.fillCircle(x + r * 0.1, y + r * 0.2, r * 0.35, COLOR_CLOUD_MID);
+    dst.fillCircle(x + r * 0.4, y + r * 0.3, r * 0.3, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.2, y + r * 0.3, r * 0.25, COLOR_CLOUD_MID);
+    dst.fillCircle(x + r * 0.05, y + r * 0.15, r * 0.2, COLOR_CLOUD); // Highlight
   }
   else if (code >= 802 && code <= 803)
   {
     // Cloudy - layered for depth
     // Dark shadow layer
-    sprite.fillCircle(x - r * 0.25, y + r * 0.3, r * 0.4, COLOR_CLOUD_DARK);
-    sprite.fillCircle(x + r * 0.25, y + r * 0.25, r * 0.35, COLOR_CLOUD_DARK);
+    dst.fillCircle(x - r * 0.25, y + r * 0.3, r * 0.4, COLOR_CLOUD_DARK);
+    dst.fillCircle(x + r * 0.25, y + r * 0.25, r * 0.35, COLOR_CLOUD_DARK);
     // Mid layer
-    sprite.fillCircle(x - r * 0.3, y - r * 0.1, r * 0.45, COLOR_CLOUD_MID);
-    sprite.fillCircle(x + r * 0.2, y - r * 0.05, r * 0.5, COLOR_CLOUD_MID);
-    sprite.fillCircle(x - r * 0.1, y + r * 0.2, r * 0.4, COLOR_CLOUD_MID);
-    sprite.fillCircle(x + r * 0.35, y + r * 0.15, r * 0.35, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.3, y - r * 0.1, r * 0.45, COLOR_CLOUD_MID);
+    dst.fillCircle(x + r * 0.2, y - r * 0.05, r * 0.5, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.1, y + r * 0.2, r * 0.4, COLOR_CLOUD_MID);
+    dst.fillCircle(x + r * 0.35, y + r * 0.15, r * 0.35, COLOR_CLOUD_MID);
     // Light highlights on top
-    sprite.fillCircle(x - r * 0.35, y - r * 0.2, r * 0.25, COLOR_CLOUD);
-    sprite.fillCircle(x + r * 0.1, y - r * 0.15, r * 0.3, COLOR_CLOUD);
+    dst.fillCircle(x - r * 0.35, y - r * 0.2, r * 0.25, COLOR_CLOUD);
+    dst.fillCircle(x + r * 0.1, y - r * 0.15, r * 0.3, COLOR_CLOUD);
   }
   else if (code == 804)
   {
     // Overcast - darker clouds, no highlights
-    sprite.fillCircle(x - r * 0.25, y + r * 0.3, r * 0.4, COLOR_OVERCAST);
-    sprite.fillCircle(x + r * 0.25, y + r * 0.25, r * 0.35, COLOR_OVERCAST);
-    sprite.fillCircle(x - r * 0.3, y - r * 0.1, r * 0.45, COLOR_CLOUD_DARK);
-    sprite.fillCircle(x + r * 0.2, y - r * 0.05, r * 0.5, COLOR_CLOUD_DARK);
-    sprite.fillCircle(x - r * 0.1, y + r * 0.2, r * 0.4, COLOR_CLOUD_DARK);
-    sprite.fillCircle(x + r * 0.35, y + r * 0.15, r * 0.35, COLOR_CLOUD_DARK);
+    dst.fillCircle(x - r * 0.25, y + r * 0.3, r * 0.4, COLOR_OVERCAST);
+    dst.fillCircle(x + r * 0.25, y + r * 0.25, r * 0.35, COLOR_OVERCAST);
+    dst.fillCircle(x - r * 0.3, y - r * 0.1, r * 0.45, COLOR_CLOUD_DARK);
+    dst.fillCircle(x + r * 0.2, y - r * 0.05, r * 0.5, COLOR_CLOUD_DARK);
+    dst.fillCircle(x - r * 0.1, y + r * 0.2, r * 0.4, COLOR_CLOUD_DARK);
+    dst.fillCircle(x + r * 0.35, y + r * 0.15, r * 0.35, COLOR_CLOUD_DARK);
     // Subtle mid-tone on top
-    sprite.fillCircle(x - r * 0.35, y - r * 0.2, r * 0.2, COLOR_CLOUD_MID);
-    sprite.fillCircle(x + r * 0.1, y - r * 0.15, r * 0.25, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.35, y - r * 0.2, r * 0.2, COLOR_CLOUD_MID);
+    dst.fillCircle(x + r * 0.1, y - r * 0.15, r * 0.25, COLOR_CLOUD_MID);
   }
   else if (code >= 500 && code <= 531)
   {
     // Rain - cloud with depth and vertical rain lines
     // Dark shadow
-    sprite.fillCircle(x - r * 0.1, y + r * 0.05, r * 0.35, COLOR_CLOUD_DARK);
+    dst.fillCircle(x - r * 0.1, y + r * 0.05, r * 0.35, COLOR_CLOUD_DARK);
     // Mid layer
-    sprite.fillCircle(x - r * 0.25, y - r * 0.3, r * 0.35, COLOR_CLOUD_MID);
-    sprite.fillCircle(x + r * 0.15, y - r * 0.25, r * 0.4, COLOR_CLOUD_MID);
-    sprite.fillCircle(x - r * 0.05, y - r * 0.1, r * 0.35, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.25, y - r * 0.3, r * 0.35, COLOR_CLOUD_MID);
+    dst.fillCircle(x + r * 0.15, y - r * 0.25, r * 0.4, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.05, y - r * 0.1, r * 0.35, COLOR_CLOUD_MID);
     // Highlights
-    sprite.fillCircle(x - r * 0.3, y - r * 0.35, r * 0.2, COLOR_CLOUD);
-    sprite.fillCircle(x + r * 0.1, y - r * 0.3, r * 0.22, COLOR_CLOUD);
+    dst.fillCircle(x - r * 0.3, y - r * 0.35, r * 0.2, COLOR_CLOUD);
+    dst.fillCircle(x + r * 0.1, y - r * 0.3, r * 0.22, COLOR_CLOUD);
     // Vertical rain lines
     for (int i = 0; i < 5; i++)
     {
       int dx = x - r * 0.35 + i * r * 0.18;
       int dy1 = y + r * 0.15;
       int dy2 = y + r * 0.5 + (i % 2) * r * 0.15; // Staggered lengths
-      sprite.drawLine(dx, dy1, dx, dy2, COLOR_RAIN);
+      dst.drawLine(dx, dy1, dx, dy2, COLOR_RAIN);
     }
   }
   else if (code >= 200 && code <= 232)
   {
     // Thunderstorm - darker clouds for stormy look
-    sprite.fillCircle(x - r * 0.1, y + r * 0.05, r * 0.35, COLOR_CLOUD_DARK);
-    sprite.fillCircle(x - r * 0.25, y - r * 0.3, r * 0.35, COLOR_CLOUD_DARK);
-    sprite.fillCircle(x + r * 0.15, y - r * 0.25, r * 0.4, COLOR_CLOUD_MID);
-    sprite.fillCircle(x - r * 0.05, y - r * 0.1, r * 0.35, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.1, y + r * 0.05, r * 0.35, COLOR_CLOUD_DARK);
+    dst.fillCircle(x - r * 0.25, y - r * 0.3, r * 0.35, COLOR_CLOUD_DARK);
+    dst.fillCircle(x + r * 0.15, y - r * 0.25, r * 0.4, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.05, y - r * 0.1, r * 0.35, COLOR_CLOUD_MID);
     // Small highlight
-    sprite.fillCircle(x + r * 0.1, y - r * 0.3, r * 0.18, COLOR_CLOUD);
+    dst.fillCircle(x + r * 0.1, y - r * 0.3, r * 0.18, COLOR_CLOUD);
     // Lightning bolt
     int bx = x;
     int by = y + r * 0.1;
-    sprite.fillTriangle(bx, by, bx + r * 0.25, by + r * 0.3, bx - r * 0.1, by + r * 0.35, COLOR_BOLT);
-    sprite.fillTriangle(bx - r * 0.05, by + r * 0.3, bx + r * 0.15, by + r * 0.35, bx - r * 0.15, by + r * 0.7, COLOR_BOLT);
+    dst.fillTriangle(bx, by, bx + r * 0.25, by + r * 0.3, bx - r * 0.1, by + r * 0.35, COLOR_BOLT);
+    dst.fillTriangle(bx - r * 0.05, by + r * 0.3, bx + r * 0.15, by + r * 0.35, bx - r * 0.15, by + r * 0.7, COLOR_BOLT);
   }
   else if (code >= 600 && code <= 622)
   {
     // Snow - cloud with depth
-    sprite.fillCircle(x - r * 0.1, y + r * 0.05, r * 0.35, COLOR_CLOUD_DARK);
-    sprite.fillCircle(x - r * 0.25, y - r * 0.3, r * 0.35, COLOR_CLOUD_MID);
-    sprite.fillCircle(x + r * 0.15, y - r * 0.25, r * 0.4, COLOR_CLOUD_MID);
-    sprite.fillCircle(x - r * 0.05, y - r * 0.1, r * 0.35, COLOR_CLOUD_MID);
-    sprite.fillCircle(x - r * 0.3, y - r * 0.35, r * 0.2, COLOR_CLOUD);
-    sprite.fillCircle(x + r * 0.1, y - r * 0.3, r * 0.22, COLOR_CLOUD);
+    dst.fillCircle(x - r * 0.1, y + r * 0.05, r * 0.35, COLOR_CLOUD_DARK);
+    dst.fillCircle(x - r * 0.25, y - r * 0.3, r * 0.35, COLOR_CLOUD_MID);
+    dst.fillCircle(x + r * 0.15, y - r * 0.25, r * 0.4, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.05, y - r * 0.1, r * 0.35, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.3, y - r * 0.35, r * 0.2, COLOR_CLOUD);
+    dst.fillCircle(x + r * 0.1, y - r * 0.3, r * 0.22, COLOR_CLOUD);
     // Snowflakes
-    sprite.fillCircle(x - r * 0.3, y + r * 0.35, 3, COLOR_SNOW);
-    sprite.fillCircle(x, y + r * 0.45, 3, COLOR_SNOW);
-    sprite.fillCircle(x + r * 0.3, y + r * 0.35, 3, COLOR_SNOW);
+    dst.fillCircle(x - r * 0.3, y + r * 0.35, 3, COLOR_SNOW);
+    dst.fillCircle(x, y + r * 0.45, 3, COLOR_SNOW);
+    dst.fillCircle(x + r * 0.3, y + r * 0.35, 3, COLOR_SNOW);
   }
   else if (code >= 701 && code <= 781)
   {
     // Atmosphere (mist, fog) - layered with varying opacity
-    uint16_t mistDark = sprite.color565(70, 70, 70);
-    uint16_t mistMid = sprite.color565(100, 100, 100);
-    uint16_t mistLight = sprite.color565(140, 140, 140);
-    sprite.fillCircle(x - r * 0.1, y + r * 0.1, r * 0.3, mistDark);
-    sprite.fillCircle(x - r * 0.3, y - r * 0.2, r * 0.3, mistMid);
-    sprite.fillCircle(x + r * 0.1, y - r * 0.15, r * 0.35, mistMid);
-    sprite.fillCircle(x - r * 0.35, y - r * 0.25, r * 0.18, mistLight);
+    uint16_t mistDark = frameColor(70, 70, 70);
+    uint16_t mistMid = frameColor(100, 100, 100);
+    uint16_t mistLight = frameColor(140, 140, 140);
+    dst.fillCircle(x - r * 0.1, y + r * 0.1, r * 0.3, mistDark);
+    dst.fillCircle(x - r * 0.3, y - r * 0.2, r * 0.3, mistMid);
+    dst.fillCircle(x + r * 0.1, y - r * 0.15, r * 0.35, mistMid);
+    dst.fillCircle(x - r * 0.35, y - r * 0.25, r * 0.18, mistLight);
     // Mist lines with varying shades
     for (int i = 0; i < 3; i++)
     {
       int ly = y + r * 0.3 + i * 8;
       uint16_t lineColor = (i == 1) ? mistMid : mistDark;
-      sprite.drawLine(x - r * 0.5, ly, x + r * 0.5, ly, lineColor);
+      dst.drawLine(x - r * 0.5, ly, x + r * 0.5, ly, lineColor);
     }
   }
   else
   {
     // Default cloud with depth
-    sprite.fillCircle(x, y + r * 0.1, r * 0.35, COLOR_CLOUD_DARK);
-    sprite.fillCircle(x - r * 0.2, y, r * 0.4, COLOR_CLOUD_MID);
-    sprite.fillCircle(x + r * 0.2, y - r * 0.05, r * 0.45, COLOR_CLOUD_MID);
-    sprite.fillCircle(x - r * 0.25, y - r * 0.1, r * 0.2, COLOR_CLOUD);
+    dst.fillCircle(x, y + r * 0.1, r * 0.35, COLOR_CLOUD_DARK);
+    dst.fillCircle(x - r * 0.2, y, r * 0.4, COLOR_CLOUD_MID);
+    dst.fillCircle(x + r * 0.2, y - r * 0.05, r * 0.45, COLOR_CLOUD_MID);
+    dst.fillCircle(x - r * 0.25, y - r * 0.1, r * 0.2, COLOR_CLOUD);
   }
 }
 ////////////////////////////////////////////////////////////////////////
@@ -933,11 +1888,12 @@ void drawHeader()
   if (!getLocalTime(&timeinfo))
     return;
 
-  // Location on the left
+  // Location on the left, elided short of the time box at x=200
   sprite.setTextDatum(ML_DATUM);
   sprite.setTextFont(4);
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
-  sprite.drawString("Caloundra, QLD", 10, 15);
+  char name[48];
+  sprite.drawString(text.elide(LOCATIONS[currentLocation].name, 200 - 10 - 4, name, sizeof(name)), 10, 15);
 
   // Time on the right with flashing colon
   int hour = timeinfo.tm_hour;
@@ -947,8 +1903,11 @@ void drawHeader()
   else if (hour > 12)
     hour -= 12;
 
-  // Clear time area first (to handle width changes)
+  // Clear time area first (to handle width changes). The location text is
+  // redrawn identically every call, so only the time box needs pushing.
   sprite.fillRect(200, 0, 120, 30, COLOR_BG);
+  dirty.mark(200, 0, 120, 30);
+  drawLinkGlyph(204, 15);
 
   sprite.setTextDatum(MR_DATUM);
   uint16_t timeColor = isDaytime() ? COLOR_DAYTIME : COLOR_SUBTLE;
@@ -957,13 +1916,13 @@ void drawHeader()
   char hourStr[4];
   sprintf(hourStr, "%d", hour);
   sprite.setTextColor(timeColor, COLOR_BG);
-  int hourWidth = sprite.textWidth(hourStr);
+  int hourWidth = text.measure(hourStr);
 
   // Calculate positions
   char minStr[8];
   sprintf(minStr, "%02d%s", timeinfo.tm_min, ampm.c_str());
-  int minWidth = sprite.textWidth(minStr);
-  int colonWidth = sprite.textWidth(":");
+  int minWidth = text.measure(minStr);
+  int colonWidth = text.measureStatic(":");
 
   int totalWidth = hourWidth + colonWidth + minWidth;
   int startX = 310 - totalWidth;
@@ -987,6 +1946,25 @@ void drawHeader()
 /////// @brief Draw footer with date at bottom left
 void drawFooter()
 {
+  // Old data on screen - say how old instead of showing the date
+  if (weatherStale)
+  {
+    char staleStr[32] = "Cached forecast";
+    if (staleSince > 0)
+    {
+      struct tm savedTm;
+      localtime_r(&staleSince, &savedTm);
+      strftime(staleStr, sizeof(staleStr), "Cached %a %H:%M", &savedTm);
+    }
+    sprite.setTextDatum(ML_DATUM);
+    sprite.setTextFont(2);
+    sprite.setTextColor(COLOR_ACCENT, COLOR_BG);
+    sprite.drawString(staleStr, 10, 222);
+    int fontH = sprite.fontHeight();
+    dirty.mark(10, 222 - fontH / 2, text.measure(staleStr), fontH);
+    return;
+  }
+
   struct tm timeinfo;
   if (!getLocalTime(&timeinfo))
     return;
@@ -1001,63 +1979,44 @@ void drawFooter()
   sprite.setTextFont(4);
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
   sprite.drawString(dateStr, 10, 222);
+  int fontH = sprite.fontHeight();
+  dirty.mark(10, 222 - fontH / 2, text.measure(dateStr), fontH);
+}
+//////////////////////////////////////////////////////////////////////////
+/////// @brief Draw a small WiFi status glyph left of the clock (nothing when online)
+void drawLinkGlyph(int x, int y)
+{
+  LinkState link = wifiLink.state();
+  if (link == LINK_ONLINE)
+    return;
+
+  // Three bars, filled as the join progresses; all hollow while backing off
+  int filled = (link == LINK_ASSOCIATING) ? 1 : (link == LINK_DHCP) ? 2 : (link == LINK_NTP) ? 3 : 0;
+  const int barW = 3;
+  const int gap = 1;
+  for (int i = 0; i < 3; i++)
+  {
+    int h = 4 + i * 3;
+    int bx = x + i * (barW + gap);
+    int by = y + 5 - h;
+    if (i < filled)
+      sprite.fillRect(bx, by, barW, h, COLOR_ACCENT);
+    else
+      sprite.drawRect(bx, by, barW, h, COLOR_SUBTLE);
+  }
 }
 //////////////////////////////////////////////////////////////////////////
 /////// @brief Draw screen indicator dots at bottom right
 void drawScreenIndicator()
 {
   int y = 222;
-  int numDots = settingsMode ? 5 : 4;
+  const ScreenInfo &info = SCREENS[currentScreen];
+  int numDots = groupSize(SCREENS, info.group);
   int spacing = 15;
   int startX = 310 - (numDots - 1) * spacing; // Right aligned
+  int screenIndex = info.order;
 
-  int screenIndex;
-  if (settingsMode)
-  {
-    switch (currentScreen)
-    {
-    case SCREEN_SETTINGS:
-      screenIndex = 0;
-      break;
-    case SCREEN_ABOUT:
-      screenIndex = 1;
-      break;
-    case SCREEN_DEMO:
-      screenIndex = 2;
-      break;
-    case SCREEN_DEMO2:
-      screenIndex = 3;
-      break;
-    case SCREEN_DEMO3:
-      screenIndex = 4;
-      break;
-    default:
-      screenIndex = 0;
-      break;
-    }
-  }
-  else
-  {
-    switch (currentScreen)
-    {
-    case SCREEN_HOURLY:
-      screenIndex = 0;
-      break;
-    case SCREEN_HOURLY2:
-      screenIndex = 1;
-      break;
-    case SCREEN_CONDITIONS:
-      screenIndex = 2;
-      break;
-    case SCREEN_DAILY:
-      screenIndex = 3;
-      break;
-    default:
-      screenIndex = 0;
-      break;
-    }
-  }
-
+  dirty.mark(startX - 5, y - 5, (numDots - 1) * spacing + 11, 11);
   for (int i = 0; i < numDots; i++)
   {
     int x = startX + i * spacing;
@@ -1075,11 +2034,12 @@ void drawScreenIndicator()
 /////// @brief Display hourly forecast screen
 void displayHourlyForecast()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_HOURLY);
+  clearFrame();
   int row1Height = 40;
   int iconSize = 55;
 
-  if (!weather.dataValid || weather.hourlyCount == 0)
+  if (!weather->dataValid || weather->hourlyCount == 0)
   {
     displayError("No Hourly Data!");
     return;
@@ -1089,33 +2049,34 @@ void displayHourlyForecast()
 
   // === NOW ROW ===
   // Weather icon on left
-  drawWeatherIcon(weather.weatherCode, 45, row1Height + (iconSize / 2), iconSize , !isDaytime());
+  drawWeatherIcon(weather->weatherCode, 45, row1Height + (iconSize / 2), iconSize , !isDaytime());
 
   // Large temperature
   sprite.setTextDatum(TL_DATUM);
   sprite.setTextFont(7);
-  sprite.setTextColor(getTempColor(weather.temperature), COLOR_BG);
-  sprite.drawString(String(weather.temperature, 0), 80, row1Height);
+  sprite.setTextColor(view.tempColor, COLOR_BG);
+  sprite.drawString(view.temp, 80, row1Height);
 
 
   // Condition text (smaller font if too long)
   sprite.setTextDatum(TL_DATUM);
-  sprite.setTextFont(weather.condition.length() > 12 ? 2 : 4);
+  sprite.setTextFont(strlen(weather->condition) > 12 ? 2 : 4);
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
-  sprite.drawString(weather.condition, 160, row1Height);
+  sprite.drawString(weather->condition, 160, row1Height);
 
-  // Summary text
+  // Summary text, wrapped when the data arrived
   sprite.setTextDatum(TL_DATUM);
-  sprite.setTextFont(2);
+  sprite.setTextFont(SUMMARY_FONT);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-  drawWrappedString(weather.daily[0].summary, 160, row1Height + 30, 150);
+  for (int i = 0; i < view.lineCount; i++)
+    sprite.drawString(view.summary + view.lineStart[i], 160, row1Height + 30 + i * sprite.fontHeight());
 
   
   // Feels like
   sprite.setTextDatum(TL_DATUM);
   sprite.setTextFont(2);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-  sprite.drawString("Feels " + String(weather.apparent_temp, 0), 84, row1Height + 55);
+  sprite.drawString("Feels " + String(weather->apparent_temp, 0), 84, row1Height + 55);
 
 drawHorizontalRule(125);
   int row2Height = 150;
@@ -1130,56 +2091,36 @@ drawHorizontalRule(125);
   sprite.drawString("Humidity", labelX, y);
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
   sprite.setTextDatum(MR_DATUM);
-  sprite.drawString(String(weather.humidity) + "%", 310, y);
+  sprite.drawString(String(weather->humidity) + "%", 310, y);
   y += lineHeight;
   
-  //get next sunrise or sunset
-// 1. Get current time
-time_t now;
-time(&now);
-
-// 2. Calculate differences (absolute values)
-long diffSunrise = abs(now - weather.sunrise);
-long diffSunset = abs(now - weather.sunset);
-
-// 3. Determine which is closer
-String eventLabel;
-time_t eventTime;
-
-if (diffSunrise < diffSunset) {
-    eventLabel = "Sunrise";
-    eventTime = weather.sunrise;
-} else {
-    eventLabel = "Sunset";
-    eventTime = weather.sunset;
-}
-
-// 4. Draw to Screen
-sprite.setTextFont(4);
-sprite.setTextDatum(ML_DATUM);
-sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
-sprite.drawString(eventLabel, labelX, y);
-
-sprite.setTextDatum(MR_DATUM);
-sprite.setTextColor(COLOR_SUBTLE, COLOR_BG); // Using COLOR_TEXT for the value to pop
-// Use the formatting function we created earlier
-sprite.drawString(formatWeatherTime(eventTime), 310, y);
+  // Nearest sunrise or sunset (times formatted by the view model)
+  bool rise = view.nextSunIsRise(time(NULL));
+  sprite.setTextFont(4);
+  sprite.setTextDatum(ML_DATUM);
+  sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
+  sprite.drawString(rise ? "Sunrise" : "Sunset", labelX, y);
+
+  sprite.setTextDatum(MR_DATUM);
+  sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
+  sprite.drawString(rise ? view.sunriseText : view.sunsetText, 310, y);
 
 y += lineHeight;
 
   // Footer and screen indicator
   drawFooter();
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 
 /////////////////////////////////////////////////////////////////////////
 /////// @brief Display extended hourly forecast with daily summaries
 void displayHourlyForecast2()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_HOURLY2);
+  clearFrame();
 
-  if (!weather.dataValid || weather.hourlyCount < 14)
+  if (!weather->dataValid || weather->hourlyCount < 14)
   {
     displayError("No Hourly Data!");
     return;
@@ -1202,22 +2143,23 @@ void displayHourlyForecast2()
 
   // sprite.setTextDatum(ML_DATUM);
   // sprite.setTextFont(7);
-  // int rainChance = weather.daily[0].pop;
+  // int rainChance = weather->daily[0].pop;
   // sprite.setTextColor(rainChance > 50 ? COLOR_RAIN : COLOR_TEXT, COLOR_BG);
   // sprite.drawString(String(rainChance) + "%", rainX + 25, 70);
 
   // Footer and screen indicator
   drawFooter();
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 /////////////////////////////////////////////////////////////////////////
 /////// @brief Display detailed current conditions
 void displayConditions()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_CONDITIONS);
+  clearFrame();
 
-  if (!weather.dataValid)
+  if (!weather->dataValid)
   {
     displayError("No Data!");
     return;
@@ -1234,9 +2176,9 @@ void displayConditions()
   sprite.setTextDatum(ML_DATUM);
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
   sprite.drawString("UV Index", labelX, y);
-  sprite.setTextColor(getUVColor(weather.uvi), COLOR_BG);
+  sprite.setTextColor(view.uvColor, COLOR_BG);
   sprite.setTextDatum(MR_DATUM);
-  sprite.drawString(String(weather.uvi, 1) + " " + getUVDescription(weather.uvi), 310, y);
+  sprite.drawString(view.uv, 310, y);
 
   // Visibility
   y += lineHeight;
@@ -1245,7 +2187,7 @@ void displayConditions()
   sprite.drawString("Visibility", labelX, y);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
   sprite.setTextDatum(MR_DATUM);
-  float visKm = weather.visibility / 1000.0;
+  float visKm = weather->visibility / 1000.0;
   sprite.drawString(String(visKm, 1) + " km", 310, y);
 
   // Pressure
@@ -1255,16 +2197,21 @@ void displayConditions()
   sprite.drawString("Pressure", labelX, y);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
   sprite.setTextDatum(MR_DATUM);
-  sprite.drawString(String(weather.pressure) + " hPa", 310, y);
+  sprite.drawString(String(weather->pressure) + " hPa", 310, y);
+  if (currentLocation == 0)
+  {
+    // Last 24 h between the label and the value
+    shownPressureTrend.take().draw(sprite, 124, y - 10, 68, 20, COLOR_CLOUD_MID, COLOR_TEXT);
+  }
 
   // Dew Point
   y += lineHeight;
   sprite.setTextDatum(ML_DATUM);
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
   sprite.drawString("Dew Point", labelX, y);
-  sprite.setTextColor(getTempColor(weather.dewPoint), COLOR_BG);
+  sprite.setTextColor(view.dewPointColor, COLOR_BG);
   sprite.setTextDatum(MR_DATUM);
-  sprite.drawString(String(weather.dewPoint, 0) + "'", 310, y);
+  sprite.drawString(String(weather->dewPoint, 0) + "'", 310, y);
 
   // Cloud Cover
   y += lineHeight;
@@ -1273,20 +2220,21 @@ void displayConditions()
   sprite.drawString("Cloud Cover", labelX, y);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
   sprite.setTextDatum(MR_DATUM);
-  sprite.drawString(String(weather.clouds) + "%", 310, y);
+  sprite.drawString(String(weather->clouds) + "%", 310, y);
 
   // Footer and screen indicator
   drawFooter();
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 
 
 void displayDailyForecast()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_DAILY);
+  clearFrame();
 
-  if (!weather.dataValid || weather.dailyCount == 0)
+  if (!weather->dataValid || weather->dailyCount == 0)
   {
     displayError("No Daily Data!");
     return;
@@ -1294,7 +2242,7 @@ void displayDailyForecast()
 
   drawHeader();
 
-  int displayCount = min(8, weather.dailyCount);
+  int displayCount = min(8, weather->dailyCount);
   int cellW = 80; // Half screen width
   int cellH = 80;  // Cell height (reduced to fit footer)
   int startY = 38; // Below header
@@ -1310,31 +2258,29 @@ void displayDailyForecast()
     sprite.setTextDatum(MC_DATUM);
     sprite.setTextFont(2);
     sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
-    String dayLabel = (i == 0) ? "Today" : weather.daily[i].dayName;
+    const char *dayLabel = (i == 0) ? "Today" : weather->daily[i].dayName;
     sprite.drawString(dayLabel, cellX, cellY);
 
     // Weather icon
-    drawWeatherIcon(weather.daily[i].weatherCode, cellX, cellY + 30, 35);
+    drawWeatherIcon(weather->daily[i].weatherCode, cellX, cellY + 30, 35);
 
-    // High / Low temps
+    // High / Low temps, in the colour of the high
     sprite.setTextFont(2);
     sprite.setTextDatum(MC_DATUM);
-    String tempStr = String((int)weather.daily[i].tempMax) + " / " + String((int)weather.daily[i].tempMin);
-
-    // Use color of the high temp
-    sprite.setTextColor(getTempColor(weather.daily[i].tempMax), COLOR_BG);
-    sprite.drawString(tempStr, cellX, cellY + 58);
+    sprite.setTextColor(view.daily[i].tempColor, COLOR_BG);
+    sprite.drawString(view.daily[i].temps, cellX, cellY + 58);
   }
 
   // Footer and screen indicator
   drawFooter();
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 
 void displaySettings()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_SETTINGS);
+  clearFrame();
 
   // Title
   sprite.setTextDatum(ML_DATUM);
@@ -1342,8 +2288,8 @@ void displaySettings()
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
   sprite.drawString("Settings", 10, 25);
 
-  int y = 70;
-  int lineHeight = 28;
+  int y = 62;
+  int lineHeight = 22;
 
   sprite.setTextFont(2);
 
@@ -1352,28 +2298,31 @@ void displaySettings()
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
   sprite.drawString("Location:", 20, y);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-  sprite.drawString("Aroona, QLD", 120, y);
+  sprite.drawString(LOCATIONS[currentLocation].name, 120, y);
 
   // Coordinates
   y += lineHeight;
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
   sprite.drawString("Lat/Lon:", 20, y);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-  sprite.drawString(String(LATITUDE) + ", " + String(LONGITUDE), 120, y);
+  sprite.drawString(String(LOCATIONS[currentLocation].latitude) + ", " + String(LOCATIONS[currentLocation].longitude), 120, y);
 
   // Update interval
   y += lineHeight;
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
   sprite.drawString("Update:", 20, y);
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-  sprite.drawString("Every 5 minutes", 120, y);
+  char every[32];
+  snprintf(every, sizeof(every), "Every %lu minutes", fetchRotation.cycleMs() / 60000);
+  sprite.drawString(every, 120, y);
 
   // WiFi status
   y += lineHeight;
   sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
   sprite.drawString("WiFi:", 20, y);
-  sprite.setTextColor(WiFi.status() == WL_CONNECTED ? COLOR_SUCCESS : TFT_RED, COLOR_BG);
-  sprite.drawString(WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected", 120, y);
+  bool online = wifiLink.state() == LINK_ONLINE;
+  sprite.setTextColor(online ? COLOR_SUCCESS : COLOR_ALERT, COLOR_BG);
+  sprite.drawString(online ? "Connected" : wifiLink.stateName(), 120, y);
 
   // IP Address
   y += lineHeight;
@@ -1389,44 +2338,67 @@ void displaySettings()
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
   sprite.drawString(lastUpdateTime, 120, y);
 
+  drawPerfSummary();
+
   // Screen indicator
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 
 // Display a specific screen
+//////////////////////////////////////////////////////////////////////////
+/////// @brief Two lines of live timing and memory figures at the bottom of Settings
+void drawPerfSummary()
+{
+  const int top = 186;
+  const int width = 250; // Stops short of the indicator dots
+  sprite.fillRect(0, top, width, 240 - top, COLOR_BG);
+  dirty.mark(0, top, width, 240 - top);
+
+  char line[48];
+  sprite.setTextDatum(ML_DATUM);
+  sprite.setTextFont(2);
+  sprite.setTextColor(COLOR_SUBTLE, COLOR_BG);
+  // Hourly stands in for the weather screens; stacks and the rest are on Serial
+  snprintf(line, sizeof(line), "Hourly %.1f  Push %.1f  Fetch %lu ms",
+           perf.get(PROBE_DISPLAY_HOURLY).lastUs / 1000.0, perf.get(PROBE_PUSH).lastUs / 1000.0,
+           (unsigned long)(perf.get(PROBE_FETCH_TOTAL).lastUs / 1000));
+  sprite.drawString(line, 20, 200);
+
+  MemoryStats m = perf.memory();
+  snprintf(line, sizeof(line), "Heap %uk  min %uk  block %uk",
+           (unsigned)(m.heapFree / 1024), (unsigned)(m.heapMinFree / 1024), (unsigned)(m.largestBlock / 1024));
+  sprite.drawString(line, 20, 222);
+}
+
 void displayScreen(Screen screen)
 {
-  switch (screen)
-  {
-  case SCREEN_HOURLY:
-    displayHourlyForecast();
-    break;
-  case SCREEN_HOURLY2:
-    displayHourlyForecast2();
-    break;
-  case SCREEN_CONDITIONS:
-    displayConditions();
-    break;
-  case SCREEN_DAILY:
-    displayDailyForecast();
-    break;
-  case SCREEN_SETTINGS:
-    displaySettings();
-    break;
-  case SCREEN_ABOUT:
-    displayAbout();
-    break;
-  case SCREEN_DEMO:
-    displayDemo();
-    break;
-  case SCREEN_DEMO2:
-    displayDemo2();
-    break;
-  case SCREEN_DEMO3:
-    displayDemo3();
-    break;
+  renderFrame([screen]
+              { drawScreen(screen); });
+}
+
+void drawScreen(Screen screen)
+{
+  const ScreenInfo &info = SCREENS[screen];
+#ifndef BANDED_RENDER
+  // Static screens come back from their cached frame (bands are too small to cache)
+  if (info.refresh == REFRESH_STATIC)
+  {
+    {
+      ScopedTimer timer(perf, info.probe);
+      if (staticFrames.restore(screen, sprite))
+      {
+        dirty.markAll();
+        if (!skipPush) pushFrame();
+        return;
+      }
+    }
+    info.draw();
+    staticFrames.store(screen, sprite);
+    return;
   }
+#endif
+  info.draw();
 }
 
 // Screen transition (instant)
@@ -1438,7 +2410,8 @@ void swipeTransition(Screen from, Screen to)
 // About page
 void displayAbout()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_ABOUT);
+  clearFrame();
 
   // Title
   sprite.setTextDatum(ML_DATUM);
@@ -1470,13 +2443,14 @@ void displayAbout()
   sprite.drawString("Powered by OpenWeatherMap", 10, y);
 
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 
 // Demo page showing all weather icons
 void displayDemo()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_DEMO);
+  clearFrame();
 
   // Title
   sprite.setTextDatum(MC_DATUM);
@@ -1545,13 +2519,14 @@ void displayDemo()
   sprite.drawString("Night", 280, y4);
 
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 
 // Demo page 2 - Design elements showcase
 void displayDemo2()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_DEMO2);
+  clearFrame();
 
   sprite.setTextDatum(TL_DATUM);
   sprite.setTextFont(1);
@@ -1613,7 +2588,7 @@ void displayDemo2()
     uint8_t r = (i < 70) ? 0 : (i - 70) * 255 / 70;
     uint8_t g = (i < 70) ? i * 255 / 70 : 255 - (i - 70) * 255 / 70;
     uint8_t b = (i < 70) ? 255 - i * 255 / 70 : 0;
-    sprite.drawLine(170 + i, 95, 170 + i, 110, sprite.color565(r, g, b));
+    sprite.drawLine(170 + i, 95, 170 + i, 110, frameColor(r, g, b));
   }
 
   // === PROGRESS BARS ===
@@ -1640,17 +2615,18 @@ void displayDemo2()
   // Draw arc segments
   for (int angle = 180; angle <= 360; angle += 5)
   {
-    float rad = angle * 0.0174533;
-    int x1 = cx + cos(rad) * (radius - 5);
-    int y1 = cy + sin(rad) * (radius - 5);
-    int x2 = cx + cos(rad) * radius;
-    int y2 = cy + sin(rad) * radius;
+    fixed_t c = cosDeg(angle);
+    fixed_t s = sinDeg(angle);
+    int x1 = offsetBy(cx, c, radius - 5);
+    int y1 = offsetBy(cy, s, radius - 5);
+    int x2 = offsetBy(cx, c, radius);
+    int y2 = offsetBy(cy, s, radius);
     uint16_t col = (angle < 270) ? COLOR_SUCCESS : ((angle < 330) ? COLOR_SUN : COLOR_ACCENT);
     sprite.drawLine(x1, y1, x2, y2, col);
   }
   // Needle
-  float needleAngle = 290 * 0.0174533;
-  sprite.drawLine(cx, cy, cx + cos(needleAngle) * 22, cy + sin(needleAngle) * 22, COLOR_TEXT);
+  int needleAngle = 290;
+  sprite.drawLine(cx, cy, offsetBy(cx, cosDeg(needleAngle), 22), offsetBy(cy, sinDeg(needleAngle), 22), COLOR_TEXT);
   sprite.fillCircle(cx, cy, 4, COLOR_SUBTLE);
 
   // === COLOR PALETTE ===
@@ -1666,13 +2642,14 @@ void displayDemo2()
   }
 
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 
 // Demo page 3 - Typography showcase
 void displayDemo3()
 {
-  sprite.fillSprite(COLOR_BG);
+  ScopedTimer timer(perf, PROBE_DISPLAY_DEMO3);
+  clearFrame();
 
   sprite.setTextColor(COLOR_TEXT, COLOR_BG);
   sprite.setTextDatum(TL_DATUM);
@@ -1779,7 +2756,7 @@ void displayDemo3()
   sprite.setTextDatum(TL_DATUM); // Reset
 
   drawScreenIndicator();
-  if (!skipPush) sprite.pushSprite(0, 0);
+  if (!skipPush) pushFrame();
 }
 
 void bootAnimation()
@@ -1790,17 +2767,18 @@ void bootAnimation()
   // Sun rising animation - draw directly to tft for animation effect
   for (int r = 0; r < 50; r += 4)
   {
-    tft.fillCircle(centerX, centerY, r, COLOR_SUN);
+    tft.fillCircle(centerX, centerY, r, panelColor(COLOR_SUN));
     if (r > 15)
     {
       for (int angle = 0; angle < 360; angle += 45)
       {
-        float rad = angle * 0.0174533;
-        int x1 = centerX + cos(rad) * (r + 5);
-        int y1 = centerY + sin(rad) * (r + 5);
-        int x2 = centerX + cos(rad) * (r + 15);
-        int y2 = centerY + sin(rad) * (r + 15);
-        tft.drawLine(x1, y1, x2, y2, COLOR_SUN);
+        fixed_t c = cosDeg(angle);
+        fixed_t s = sinDeg(angle);
+        int x1 = offsetBy(centerX, c, r + 5);
+        int y1 = offsetBy(centerY, s, r + 5);
+        int x2 = offsetBy(centerX, c, r + 15);
+        int y2 = offsetBy(centerY, s, r + 15);
+        tft.drawLine(x1, y1, x2, y2, panelColor(COLOR_SUN));
       }
     }
     delay(20);
@@ -1811,23 +2789,23 @@ void bootAnimation()
   // Fade out
   for (int r = 0; r < 160; r += 6)
   {
-    tft.drawCircle(centerX, centerY, r, COLOR_BG);
-    tft.drawCircle(centerX, centerY, r + 1, COLOR_BG);
-    tft.drawCircle(centerX, centerY, r + 2, COLOR_BG);
+    tft.drawCircle(centerX, centerY, r, panelColor(COLOR_BG));
+    tft.drawCircle(centerX, centerY, r + 1, panelColor(COLOR_BG));
+    tft.drawCircle(centerX, centerY, r + 2, panelColor(COLOR_BG));
     delay(8);
   }
 
-  tft.fillScreen(COLOR_BG);
+  tft.fillScreen(panelColor(COLOR_BG));
 
   // Title reveal
   String title = "Weather Reporter";
   tft.setTextDatum(MC_DATUM);
   tft.setTextFont(6);
-  tft.setTextColor(COLOR_SUBTLE, COLOR_BG);
+  tft.setTextColor(panelColor(COLOR_SUBTLE), panelColor(COLOR_BG));
 
   for (int i = 1; i <= (int)title.length(); i++)
   {
-    tft.fillRect(0, 75, 320, 55, COLOR_BG);
+    tft.fillRect(0, 75, 320, 55, panelColor(COLOR_BG));
     tft.drawString(title.substring(0, i), centerX, 100);
     delay(40);
   }
@@ -1835,10 +2813,10 @@ void bootAnimation()
   delay(200);
 
   tft.setTextFont(4);
-  tft.setTextColor(COLOR_SUBTLE, COLOR_BG);
+  tft.setTextColor(panelColor(COLOR_SUBTLE), panelColor(COLOR_BG));
   for (int x = 320; x >= centerX; x -= 10)
   {
-    tft.fillRect(0, 130, 320, 30, COLOR_BG);
+    tft.fillRect(0, 130, 320, 30, panelColor(COLOR_BG));
     tft.drawString("Aroona, QLD", x, 145);
     delay(8);
   }
@@ -1847,17 +2825,18 @@ void bootAnimation()
 
   // Loading dots
   tft.setTextFont(4);
-  tft.setTextColor(COLOR_SUBTLE, COLOR_BG);
+  tft.setTextColor(panelColor(COLOR_SUBTLE), panelColor(COLOR_BG));
   tft.drawString("Loading", centerX, 190);
 
   for (int i = 0; i < 3; i++)
   {
     for (int dot = 0; dot < 3; dot++)
     {
-      tft.fillCircle(130 + (dot * 20), 215, 5, (dot <= i) ? COLOR_SUBTLE : COLOR_BG);
+      tft.fillCircle(130 + (dot * 20), 215, 5, panelColor((dot <= i) ? COLOR_SUBTLE : COLOR_BG));
     }
     delay(250);
   }
 
   delay(200);
+  frameDiff.invalidate(); // The panel shows the animation, not the last frame
 }
@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+"""
+OWM Relay for Weather Display
+
+Fetches One Call 3.0 JSON from OpenWeatherMap once per location and serves
+it to the displays on the LAN as the compact MessagePack snapshot described
+in include/relay_snapshot.h - only the fields WeatherData keeps, as
+positional arrays, over plain HTTP.
+
+    owm_relay.py serve --api-key KEY [--port 8080] [--ttl 120]
+    owm_relay.py convert onecall.json snapshot.msgpack [--sections 15]
+
+Displays request /v1/snapshot?lat=..&lon=..&sections=N, where N is the
+SECTION_BIT mask of the sections they want. Each location is fetched from
+OWM at most once per --ttl seconds however many displays ask for it.
+
+Standard library only.
+"""
+
+import argparse
+import json
+import struct
+import sys
+import threading
+import time
+import urllib.error
+import urllib.parse
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+SNAPSHOT_VERSION = 1  # RELAY_SNAPSHOT_VERSION
+
+# SECTION_BIT() of each One Call section (types.h)
+SECTION_CURRENT = 1 << 0
+SECTION_MINUTELY = 1 << 1
+SECTION_HOURLY = 1 << 2
+SECTION_DAILY = 1 << 3
+SECTIONS_ALL = 0xF
+
+# Text capacities on the device (types.h), including the NUL
+CONDITION_LEN = 32
+SUMMARY_LEN = 128
+
+OWM_URL = "https://api.openweathermap.org/data/3.0/onecall"
+
+
+# --- MessagePack -----------------------------------------------------------
+# Just the types the snapshot uses. Integral numbers go out as ints (1-3
+# bytes for most fields), the rest as float32 - the device stores floats.
+
+def pack(value, out):
+    if value is None:
+        out.append(0xC0)
+    elif value is True or value is False:
+        out.append(0xC3 if value else 0xC2)
+    elif isinstance(value, float) and value.is_integer() and abs(value) < 2**31:
+        pack(int(value), out)
+    elif isinstance(value, int):
+        pack_int(value, out)
+    elif isinstance(value, float):
+        out.append(0xCA)
+        out += struct.pack(">f", value)
+    elif isinstance(value, str):
+        data = value.encode("utf-8")
+        n = len(data)
+        if n < 32:
+            out.append(0xA0 | n)
+        elif n < 0x100:
+            out += bytes((0xD9, n))
+        elif n < 0x10000:
+            out.append(0xDA)
+            out += struct.pack(">H", n)
+        else:
+            out.append(0xDB)
+            out += struct.pack(">I", n)
+        out += data
+    elif isinstance(value, (list, tuple)):
+        n = len(value)
+        if n < 16:
+            out.append(0x90 | n)
+        elif n < 0x10000:
+            out.append(0xDC)
+            out += struct.pack(">H", n)
+        else:
+            out.append(0xDD)
+            out += struct.pack(">I", n)
+        for item in value:
+            pack(item, out)
+    else:
+        raise TypeError("cannot pack %r" % (value,))
+
+
+def pack_int(n, out):
+    if 0 <= n < 0x80:
+        out.append(n)
+    elif -32 <= n < 0:
+        out.append(n & 0xFF)
+    elif 0 <= n < 0x100:
+        out += bytes((0xCC, n))
+    elif 0 <= n < 0x10000:
+        out.append(0xCD)
+        out += struct.pack(">H", n)
+    elif 0 <= n < 0x100000000:
+        out.append(0xCE)
+        out += struct.pack(">I", n)
+    elif n >= 0:
+        out.append(0xCF)
+        out += struct.pack(">Q", n)
+    elif n >= -0x80:
+        out += bytes((0xD0, n & 0xFF))
+    elif n >= -0x8000:
+        out.append(0xD1)
+        out += struct.pack(">h", n)
+    elif n >= -0x80000000:
+        out.append(0xD2)
+        out += struct.pack(">i", n)
+    else:
+        out.append(0xD3)
+        out += struct.pack(">q", n)
+
+
+# --- Snapshot --------------------------------------------------------------
+
+def clip(text, capacity):
+    """Trim to what the device can hold (capacity includes the NUL)."""
+    data = (text or "").encode("utf-8")[: capacity - 1]
+    return data.decode("utf-8", "ignore")
+
+
+def percent(fraction):
+    """0-1 to a whole percent, rounded to nearest as the device's JSON path does."""
+    return int(fraction * 100 + 0.5)
+
+
+def weather_id(entry):
+    weather = entry.get("weather") or [{}]
+    return weather[0].get("id", 0)
+
+
+def snapshot(onecall, sections=SECTIONS_ALL):
+    """Build the snapshot arrays from a One Call response."""
+    present = 0
+    current = minutely = hourly = daily = None
+
+    if sections & SECTION_CURRENT and "current" in onecall:
+        c = onecall["current"]
+        weather = (c.get("weather") or [{}])[0]
+        current = [
+            c.get("temp", 0), c.get("feels_like", 0), c.get("humidity", 0),
+            c.get("wind_speed", 0), c.get("wind_deg", 0), weather.get("id", 0),
+            clip(weather.get("description"), CONDITION_LEN),
+            c.get("sunrise", 0), c.get("sunset", 0), c.get("uvi", 0),
+            c.get("visibility", 0), c.get("pressure", 0), c.get("dew_point", 0),
+            c.get("clouds", 0),
+        ]
+        present |= SECTION_CURRENT
+
+    if sections & SECTION_MINUTELY:
+        # Missing where OWM has no nowcast - an empty list, not an error
+        minutely = [m.get("precipitation", 0) for m in onecall.get("minutely", [])[:60]]
+        present |= SECTION_MINUTELY
+
+    if sections & SECTION_HOURLY and "hourly" in onecall:
+        hourly = [[h.get("dt", 0), h.get("temp", 0), weather_id(h)] for h in onecall["hourly"][:24]]
+        present |= SECTION_HOURLY
+
+    if sections & SECTION_DAILY and "daily" in onecall:
+        days = onecall["daily"][:8]
+        today = days[0] if days else {}
+        daily = [
+            today.get("moonrise", 0), today.get("moonset", 0), today.get("moon_phase", 0),
+            [[d.get("dt", 0), d.get("temp", {}).get("min", 0), d.get("temp", {}).get("max", 0),
+              weather_id(d), percent(d.get("pop", 0)), clip(d.get("summary"), SUMMARY_LEN)]
+             for d in days],
+        ]
+        present |= SECTION_DAILY
+
+    out = bytearray()
+    pack([SNAPSHOT_VERSION, present, current, minutely, hourly, daily], out)
+    return bytes(out)
+
+
+# --- Relay server ----------------------------------------------------------
+
+class OneCallCache:
+    """Latest One Call response per location, refetched after ttl seconds."""
+
+    def __init__(self, api_key, ttl):
+        self.api_key = api_key
+        self.ttl = ttl
+        self.entries = {}  # (lat, lon) -> (fetched_at, response)
+        self.lock = threading.Lock()
+        self.calls = 0
+
+    def get(self, lat, lon):
+        key = (lat, lon)
+        with self.lock:
+            entry = self.entries.get(key)
+            if entry and time.time() - entry[0] < self.ttl:
+                return entry[1]
+            query = urllib.parse.urlencode(
+                {"lat": lat, "lon": lon, "units": "metric", "exclude": "alerts", "appid": self.api_key})
+            with urllib.request.urlopen(OWM_URL + "?" + query, timeout=15) as response:
+                onecall = json.load(response)
+            self.calls += 1
+            self.entries[key] = (time.time(), onecall)
+            return onecall
+
+
+def make_handler(cache):
+    class RelayHandler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"  # The display keeps its connection open
+
+        def do_GET(self):
+            url = urllib.parse.urlsplit(self.path)
+            if url.path != "/v%d/snapshot" % SNAPSHOT_VERSION:
+                self.reply(404, b"unknown path\n", "text/plain")
+                return
+            query = urllib.parse.parse_qs(url.query)
+            try:
+                lat = query["lat"][0]
+                lon = query["lon"][0]
+                sections = int(query.get("sections", [SECTIONS_ALL])[0]) & SECTIONS_ALL
+            except (KeyError, ValueError):
+                self.reply(400, b"lat and lon required\n", "text/plain")
+                return
+            try:
+                onecall = cache.get(lat, lon)
+            except (urllib.error.URLError, ValueError) as e:
+                self.log_message("OWM fetch failed: %s", e)
+                self.reply(502, b"upstream fetch failed\n", "text/plain")
+                return
+            body = snapshot(onecall, sections)
+            self.reply(200, body, "application/msgpack")
+
+        def reply(self, status, body, content_type):
+            self.send_response(status)
+            self.send_header("Content-Type", content_type)
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+    return RelayHandler
+
+
+def serve(args):
+    cache = OneCallCache(args.api_key, args.ttl)
+    server = ThreadingHTTPServer(("", args.port), make_handler(cache))
+    print("Relaying One Call snapshots on port %d (cache %d s)" % (args.port, args.ttl))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    print("%d OWM calls made" % cache.calls)
+
+
+def convert(args):
+    with open(args.input, encoding="utf-8") as f:
+        onecall = json.load(f)
+    body = snapshot(onecall, args.sections)
+    with open(args.output, "wb") as f:
+        f.write(body)
+    size = len(json.dumps(onecall, separators=(",", ":")))
+    print("%s: %d bytes of JSON -> %d bytes of snapshot" % (args.output, size, len(body)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1].strip())
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    p = commands.add_parser("serve", help="relay OWM to displays over HTTP")
+    p.add_argument("--api-key", required=True, help="OpenWeatherMap One Call 3.0 key")
+    p.add_argument("--port", type=int, default=8080)
+    p.add_argument("--ttl", type=int, default=120, help="seconds to reuse a location's response")
+    p.set_defaults(run=serve)
+
+    p = commands.add_parser("convert", help="convert a saved One Call response")
+    p.add_argument("input")
+    p.add_argument("output")
+    p.add_argument("--sections", type=int, default=SECTIONS_ALL, help="SECTION_BIT mask to include")
+    p.set_defaults(run=convert)
+
+    args = parser.parse_args()
+    args.run(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())